@@ -15,6 +15,7 @@
 IF(UNIX)
     #SET(CMAKE_INSTALL_SO_NO_EXE "0")
 	INSTALL (FILES ${ALL_LIDAR_FORMAT_HEADER_FILES} DESTINATION include/LidarFormat COMPONENT headers)
+	INSTALL (FILES ${LIDARFORMAT_OPTIONS_HEADER} DESTINATION include/LidarFormat COMPONENT headers)
 	INSTALL( FILES ${ALL_MODELS_HEADER_FILES} DESTINATION include/LidarFormat/models COMPONENT headers)
 	INSTALL( FILES ${ALL_GEOMETRY_HEADER_FILES} DESTINATION include/LidarFormat/geometry COMPONENT headers)
 	INSTALL( FILES ${ALL_TOOLS_HEADER_FILES} DESTINATION include/LidarFormat/tools COMPONENT headers)
@@ -48,6 +49,7 @@ IF(WIN32)
 	SET(LidarFormat_INSTALL_DIR "LidarFormat")
 	SET(INSTALL_PREFIX "C:/Program Files/LidarFormat" CACHE PATH " install path")
 	INSTALL (FILES ${ALL_LIDAR_FORMAT_HEADER_FILES} DESTINATION include/LidarFormat COMPONENT headers)
+	INSTALL (FILES ${LIDARFORMAT_OPTIONS_HEADER} DESTINATION include/LidarFormat COMPONENT headers)
 	INSTALL( FILES ${ALL_MODELS_HEADER_FILES} DESTINATION include/LidarFormat/models COMPONENT headers)
 	INSTALL( FILES ${ALL_GEOMETRY_HEADER_FILES} DESTINATION include/LidarFormat/geometry COMPONENT headers)
 	INSTALL( FILES ${ALL_TOOLS_HEADER_FILES} DESTINATION include/LidarFormat/tools COMPONENT headers)
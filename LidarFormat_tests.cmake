@@ -21,3 +21,9 @@ FOREACH( one_test ${all_tests} )
 
     ADD_TEST(LidarFormat_${one_test} ${one_test})
 ENDFOREACH( one_test ${all_tests} )
+
+# block views on their own, to see at a glance that the AVX2 paths pass
+if(ENABLE_AVX2)
+    ADD_TEST(LidarFormat_avx2_block_views unit_tests --run_test=LidarDataContainerTests/LidarDataView_block_tests)
+    ADD_TEST(LidarFormat_avx2_convert_views unit_tests --run_test=LidarDataContainerTests/LidarDataConvertView_tests)
+endif(ENABLE_AVX2)
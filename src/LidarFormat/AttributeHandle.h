@@ -0,0 +1,94 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef ATTRIBUTEHANDLE_H_
+#define ATTRIBUTEHANDLE_H_
+
+#include <string>
+#include <stdexcept>
+
+#include "LidarFormat/AttributesInfo.h"
+#include "LidarFormat/LidarDataFormatTypes.h"
+
+namespace Lidar
+{
+
+///Typed handle on an attribute of interleaved echoes : the name lookup and the type check are done once,
+///  accesses through the handle only add the offset
+///  ATTENTION : a handle is invalidated when the attributes of its container change (addAttributes, delAttributes...)
+template<typename T>
+class AttributeHandle
+{
+	public:
+		typedef T value_type;
+
+		AttributeHandle() : m_decalage(0) {}
+		explicit AttributeHandle(const unsigned int decalage) : m_decalage(decalage) {}
+
+		unsigned int decalage() const { return m_decalage; }
+
+		T& operator()(char* echo) const { return *reinterpret_cast<T*>(echo + m_decalage); }
+		const T& operator()(const char* echo) const { return *reinterpret_cast<const T*>(echo + m_decalage); }
+
+	private:
+		unsigned int m_decalage;
+};
+
+///Resolves the handle of attributeName (throws if the attribute is missing or is not of type T)
+template<typename T>
+AttributeHandle<T> makeAttributeHandle(const AttributeMapType& attributeMap, const std::string& attributeName)
+{
+	AttributeMapType::const_iterator it = attributeMap.find(attributeName);
+
+	if(it == attributeMap.end())
+		throw std::logic_error("Error in makeAttributeHandle : attribute " + attributeName + " is not present !\n");
+
+	if(it->second.type != LidarTypeTraits<T>::enum_type)
+		throw std::logic_error("Error in makeAttributeHandle : attribute " + attributeName + " is not of type " + LidarTypeTraits<T>::name() + " !\n");
+
+	return AttributeHandle<T>(it->second.decalage);
+}
+
+} //namespace Lidar
+
+#endif /* ATTRIBUTEHANDLE_H_ */
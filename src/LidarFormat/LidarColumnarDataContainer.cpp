@@ -0,0 +1,310 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/bind/placeholders.hpp>
+
+#include "LidarFormat/LidarDataContainer.h"
+#include "apply.h"
+
+#include "LidarColumnarDataContainer.h"
+
+
+namespace Lidar
+{
+
+namespace
+{
+
+//number of echoes transposed at once: the interleaved records of a block stay in the cache
+//while every column is filled
+const std::size_t transpositionBlockSize = 1024;
+
+template<EnumLidarDataType T>
+struct AttributeSizeFunctor
+{
+	unsigned int operator()()
+	{
+		return sizeof( typename LidarEnumTypeTraits<T>::type );
+	}
+};
+
+//the size is a compile-time constant: each memcpy becomes a single move
+template<std::size_t N>
+void gatherColumn(char* column, const char* records, const unsigned int stride, const std::size_t nbEchos)
+{
+	for(std::size_t i = 0; i < nbEchos; ++i)
+		std::memcpy(column + i*N, records + i*stride, N);
+}
+
+template<std::size_t N>
+void scatterColumn(char* records, const char* column, const unsigned int stride, const std::size_t nbEchos)
+{
+	for(std::size_t i = 0; i < nbEchos; ++i)
+		std::memcpy(records + i*stride, column + i*N, N);
+}
+
+void gatherColumn(const unsigned int size, char* column, const char* records, const unsigned int stride, const std::size_t nbEchos)
+{
+	switch(size)
+	{
+		case 1: gatherColumn<1>(column, records, stride, nbEchos); break;
+		case 2: gatherColumn<2>(column, records, stride, nbEchos); break;
+		case 4: gatherColumn<4>(column, records, stride, nbEchos); break;
+		case 8: gatherColumn<8>(column, records, stride, nbEchos); break;
+		default:
+			for(std::size_t i = 0; i < nbEchos; ++i)
+				std::memcpy(column + i*size, records + i*stride, size);
+	}
+}
+
+void scatterColumn(const unsigned int size, char* records, const char* column, const unsigned int stride, const std::size_t nbEchos)
+{
+	switch(size)
+	{
+		case 1: scatterColumn<1>(records, column, stride, nbEchos); break;
+		case 2: scatterColumn<2>(records, column, stride, nbEchos); break;
+		case 4: scatterColumn<4>(records, column, stride, nbEchos); break;
+		case 8: scatterColumn<8>(records, column, stride, nbEchos); break;
+		default:
+			for(std::size_t i = 0; i < nbEchos; ++i)
+				std::memcpy(records + i*stride, column + i*size, size);
+	}
+}
+
+} //namespace
+
+
+LidarColumnarDataContainer::LidarColumnarDataContainer():
+	attributeMap_(new AttributeMapType), size_(0), capacity_(0), pointSize_(0)
+{
+}
+
+LidarColumnarDataContainer::LidarColumnarDataContainer(const LidarDataContainer& lidarContainer):
+	attributeMap_(new AttributeMapType), size_(0), capacity_(0), pointSize_(0)
+{
+	assign(lidarContainer);
+}
+
+bool LidarColumnarDataContainer::addAttribute(const std::string& attributeName, const EnumLidarDataType type)
+{
+	//si l'attribut existe déjà, on sort et retourne false
+	if(attributeMap_->find(attributeName)!=attributeMap_->end())
+		return false;
+
+	const unsigned int attributeSize = apply<AttributeSizeFunctor, unsigned int>(type);
+
+	//same offsets as in the interleaved records, for the conversions
+	AttributesInfo infos;
+	infos.type = type;
+	infos.decalage = pointSize_;
+
+	//the description is shared by the copies of the container: copy on write
+	attributeMap_.reset(new AttributeMapType(*attributeMap_));
+	attributeMap_->push_back(AttributeMapType::value_type(attributeName, infos));
+	attributeSizes_.push_back(attributeSize);
+	pointSize_ += attributeSize;
+
+	//the columns that follow the last one do not move: only the storage has to grow
+	std::vector<std::size_t> offsets;
+	std::size_t totalSize;
+	computeColumnOffsets(capacity_, offsets, totalSize);
+	columnOffsets_.push_back(offsets.back());
+	lidarData_.resize(totalSize);
+
+	return true;
+}
+
+bool LidarColumnarDataContainer::checkAttributeIsPresent(const std::string& attributeName) const
+{
+	return attributeMap_->find(attributeName) != attributeMap_->end();
+}
+
+EnumLidarDataType LidarColumnarDataContainer::getAttributeType(const std::string &attributeName) const
+{
+	return attributeMap_->find(attributeName)->second.type;
+}
+
+void LidarColumnarDataContainer::getAttributeList(std::vector<std::string> &liste) const
+{
+	liste.clear();
+	std::transform(attributeMap_->begin(), attributeMap_->end(), std::back_inserter(liste),
+			boost::bind( &AttributeMapType::value_type::first, _1 )
+	);
+}
+
+std::size_t LidarColumnarDataContainer::indexOf(const std::string &attributeName) const
+{
+	const AttributeMapType::const_iterator it = attributeMap_->find(attributeName);
+	if(it == attributeMap_->end())
+		throw std::logic_error("Error in LidarColumnarDataContainer : no attribute " + attributeName + " !\n");
+
+	return it - attributeMap_->begin();
+}
+
+void LidarColumnarDataContainer::resize(const std::size_t nbEchos)
+{
+	if(nbEchos > capacity_)
+		relayout(std::max(nbEchos, 2*capacity_));
+
+	//like the interleaved container, new echoes are set to 0
+	if(nbEchos > size_)
+		for(std::size_t i = 0; i < columnOffsets_.size(); ++i)
+			std::memset(rawData() + columnOffsets_[i] + size_*attributeSizes_[i], 0, (nbEchos - size_)*attributeSizes_[i]);
+
+	size_ = nbEchos;
+}
+
+void LidarColumnarDataContainer::reserve(const std::size_t nbEchos)
+{
+	if(nbEchos > capacity_)
+		relayout(nbEchos);
+}
+
+void LidarColumnarDataContainer::clear()
+{
+	size_ = 0;
+}
+
+void LidarColumnarDataContainer::computeColumnOffsets(const std::size_t nbEchos, std::vector<std::size_t>& offsets, std::size_t& totalSize) const
+{
+	offsets.resize(attributeSizes_.size());
+	totalSize = 0;
+	for(std::size_t i = 0; i < attributeSizes_.size(); ++i)
+	{
+		offsets[i] = totalSize;
+		const std::size_t columnSize = nbEchos*attributeSizes_[i];
+		totalSize += (columnSize + LidarDataBuffer::alignment - 1) / LidarDataBuffer::alignment * LidarDataBuffer::alignment;
+	}
+}
+
+void LidarColumnarDataContainer::relayout(const std::size_t nbEchos)
+{
+	assert(nbEchos >= size_);
+
+	std::vector<std::size_t> offsets;
+	std::size_t totalSize;
+	computeColumnOffsets(nbEchos, offsets, totalSize);
+
+	//only the size_ first values of each column are copied, resize() sets the others
+	LidarDataBuffer newData;
+	newData.setAllocator(lidarData_.getAllocator());
+	newData.resizeUninitialized(totalSize);
+	if(size_ > 0)
+		for(std::size_t i = 0; i < offsets.size(); ++i)
+			std::memcpy(newData.data() + offsets[i], rawData() + columnOffsets_[i], size_*attributeSizes_[i]);
+
+	lidarData_.swap(newData);
+	columnOffsets_.swap(offsets);
+	capacity_ = nbEchos;
+}
+
+void LidarColumnarDataContainer::assign(const LidarDataContainer& lidarContainer)
+{
+	attributeMap_.reset(new AttributeMapType(lidarContainer.getAttributeMap()));
+	pointSize_ = lidarContainer.pointSize();
+
+	attributeSizes_.clear();
+	for(AttributeMapType::const_iterator it = attributeMap_->begin(); it != attributeMap_->end(); ++it)
+		attributeSizes_.push_back(apply<AttributeSizeFunctor, unsigned int>(it->second.type));
+
+	size_ = lidarContainer.size();
+	capacity_ = size_;
+	std::size_t totalSize;
+	computeColumnOffsets(capacity_, columnOffsets_, totalSize);
+
+	//the columns are filled below
+	LidarDataBuffer newData;
+	newData.setAllocator(lidarData_.getAllocator());
+	newData.resizeUninitialized(totalSize);
+	lidarData_.swap(newData);
+
+	const char* records = lidarContainer.rawData();
+	for(std::size_t first = 0; first < size_; first += transpositionBlockSize)
+	{
+		const std::size_t nbEchos = std::min(transpositionBlockSize, size_ - first);
+		std::size_t i = 0;
+		for(AttributeMapType::const_iterator it = attributeMap_->begin(); it != attributeMap_->end(); ++it, ++i)
+			gatherColumn(attributeSizes_[i], rawData() + columnOffsets_[i] + first*attributeSizes_[i],
+					records + first*pointSize_ + it->second.decalage, pointSize_, nbEchos);
+	}
+}
+
+void LidarColumnarDataContainer::toInterleaved(LidarDataContainer& lidarContainer) const
+{
+	if(lidarContainer.getAttributeMap().empty())
+	{
+		for(AttributeMapType::const_iterator it = attributeMap_->begin(); it != attributeMap_->end(); ++it)
+			lidarContainer.addAttribute(it->first, it->second.type);
+	}
+	else if(lidarContainer.getAttributeMap().size() != attributeMap_->size() || lidarContainer.pointSize() != pointSize_)
+		throw std::logic_error("Error in LidarColumnarDataContainer::toInterleaved : the attributes of the containers are different !\n");
+
+	//every attribute found by name with the same type before anything is written
+	std::vector<unsigned int> decalages;
+	decalages.reserve(attributeMap_->size());
+	for(AttributeMapType::const_iterator it = attributeMap_->begin(); it != attributeMap_->end(); ++it)
+	{
+		const AttributeMapType::const_iterator itTarget = lidarContainer.getAttributeMap().find(it->first);
+		if(itTarget == lidarContainer.getAttributeMap().end() || itTarget->second.type != it->second.type)
+			throw std::logic_error("Error in LidarColumnarDataContainer::toInterleaved : attribute " + it->first + " is not in the container, or has another type !\n");
+		decalages.push_back(itTarget->second.decalage);
+	}
+
+	lidarContainer.resize(size_);
+
+	char* records = lidarContainer.rawData();
+	for(std::size_t first = 0; first < size_; first += transpositionBlockSize)
+	{
+		const std::size_t nbEchos = std::min(transpositionBlockSize, size_ - first);
+		for(std::size_t i = 0; i < decalages.size(); ++i)
+			scatterColumn(attributeSizes_[i], records + first*pointSize_ + decalages[i],
+					rawData() + columnOffsets_[i] + first*attributeSizes_[i], pointSize_, nbEchos);
+	}
+}
+
+} //namespace Lidar
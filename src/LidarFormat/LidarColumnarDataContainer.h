@@ -0,0 +1,206 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef LIDARCOLUMNARDATACONTAINER_H_
+#define LIDARCOLUMNARDATACONTAINER_H_
+
+#include <string>
+#include <vector>
+#include <cassert>
+
+#include <boost/shared_ptr.hpp>
+
+#include "LidarFormat/AttributesInfo.h"
+#include "LidarFormat/LidarDataBuffer.h"
+#include "LidarFormat/LidarIteratorAttribute.h"
+#include "LidarFormat/LidarDataFormatTypes.h"
+
+
+namespace Lidar
+{
+
+using boost::shared_ptr;
+
+class LidarDataContainer;
+
+/**
+* @brief Columnar (structure of arrays) storage of a point cloud.
+*
+* Same attributes as a LidarDataContainer (the AttributeMapType is shared, with the
+* offsets of the interleaved records), but each attribute is stored in its own contiguous
+* column, aligned on LidarDataBuffer::alignment bytes. Attribute iterators and views
+* walk the columns with a unit stride, so that loops over one attribute can be vectorized.
+*
+* Echo access is not available in this layout: convert back with toInterleaved() to use
+* LidarEcho, LidarIteratorEcho or the file formats.
+*
+*/
+
+class LidarColumnarDataContainer
+{
+	public:
+		LidarColumnarDataContainer();
+		///Conversion from interleaved records
+		explicit LidarColumnarDataContainer(const LidarDataContainer& lidarContainer);
+
+		///Can be called on a filled container: the new column is initialized to 0
+		bool addAttribute(const std::string& attributeName, const EnumLidarDataType type);
+
+		bool checkAttributeIsPresent(const std::string& attributeName) const;
+		EnumLidarDataType getAttributeType(const std::string &attributeName) const;
+		void getAttributeList(std::vector<std::string> &liste) const;
+		const AttributeMapType& getAttributeMap() const { return *attributeMap_; }
+
+		///Taille d'un écho entrelacé
+		unsigned int pointSize() const { return pointSize_; }
+
+
+		///Interface semblable au vector :
+		bool empty() const { return size_==0; }
+		std::size_t size() const { return size_; }
+		std::size_t capacity() const { return capacity_; }
+		void resize(const std::size_t nbEchos);
+		void reserve(const std::size_t nbEchos);
+		void clear();
+
+
+		///Start of the storage: column k starts at rawData() + getColumnOffset(name of k)
+		char* rawData() { return lidarData_.data(); }
+		const char* rawData() const { return lidarData_.data(); }
+
+		///Offset in bytes of a column from rawData(), to be used with the views (LidarDataView.hpp) along with getStride()
+		std::size_t getColumnOffset(const std::string &attributeName) const;
+		///Distance in bytes between two values of an attribute (size of its type)
+		unsigned int getStride(const std::string &attributeName) const;
+
+		template<typename T> T* column(const std::string &attributeName);
+		template<typename T> const T* column(const std::string &attributeName) const;
+
+		template<typename T> LidarIteratorAttribute<T> beginAttribute(const std::string &attributeName);
+		template<typename T> LidarIteratorAttribute<T> endAttribute(const std::string &attributeName);
+		template<typename T> LidarConstIteratorAttribute<T> beginAttribute(const std::string &attributeName) const;
+		template<typename T> LidarConstIteratorAttribute<T> endAttribute(const std::string &attributeName) const;
+
+
+		///Conversions (par blocs d'échos, pour rester dans le cache)
+		///  assign replaces the attributes and the data by those of lidarContainer
+		void assign(const LidarDataContainer& lidarContainer);
+		///  the attributes of an empty lidarContainer are set, otherwise they must match
+		void toInterleaved(LidarDataContainer& lidarContainer) const;
+
+	private:
+		std::size_t indexOf(const std::string &attributeName) const;
+
+		///Moves the columns to a new storage of nbEchos capacity
+		void relayout(const std::size_t nbEchos);
+
+		///Column offsets for a given capacity
+		void computeColumnOffsets(const std::size_t nbEchos, std::vector<std::size_t>& offsets, std::size_t& totalSize) const;
+
+
+		LidarDataBuffer lidarData_;
+		shared_ptr<AttributeMapType> attributeMap_;
+
+		//same order as attributeMap_
+		std::vector<std::size_t> columnOffsets_;
+		std::vector<unsigned int> attributeSizes_;
+
+		std::size_t size_;
+		std::size_t capacity_;
+		unsigned int pointSize_;
+};
+
+
+///////////////IMPLEMENTATION TEMPLATE et INLINE
+
+inline std::size_t LidarColumnarDataContainer::getColumnOffset(const std::string &attributeName) const
+{
+	return columnOffsets_[indexOf(attributeName)];
+}
+
+inline unsigned int LidarColumnarDataContainer::getStride(const std::string &attributeName) const
+{
+	return attributeSizes_[indexOf(attributeName)];
+}
+
+template<typename T>
+inline T* LidarColumnarDataContainer::column(const std::string &attributeName)
+{
+	assert(sizeof(T) == getStride(attributeName));
+	return reinterpret_cast<T*>(rawData() + getColumnOffset(attributeName));
+}
+
+template<typename T>
+inline const T* LidarColumnarDataContainer::column(const std::string &attributeName) const
+{
+	assert(sizeof(T) == getStride(attributeName));
+	return reinterpret_cast<const T*>(rawData() + getColumnOffset(attributeName));
+}
+
+template<typename T>
+inline LidarIteratorAttribute<T> LidarColumnarDataContainer::beginAttribute(const std::string &attributeName)
+{
+	return LidarIteratorAttribute<T>(reinterpret_cast<char*>(column<T>(attributeName)), sizeof(T));
+}
+
+template<typename T>
+inline LidarIteratorAttribute<T> LidarColumnarDataContainer::endAttribute(const std::string &attributeName)
+{
+	return LidarIteratorAttribute<T>(reinterpret_cast<char*>(column<T>(attributeName) + size()), sizeof(T));
+}
+
+template<typename T>
+inline LidarConstIteratorAttribute<T> LidarColumnarDataContainer::beginAttribute(const std::string &attributeName) const
+{
+	return LidarConstIteratorAttribute<T>(const_cast<char*>(reinterpret_cast<const char*>(column<T>(attributeName))), sizeof(T));
+}
+
+template<typename T>
+inline LidarConstIteratorAttribute<T> LidarColumnarDataContainer::endAttribute(const std::string &attributeName) const
+{
+	return LidarConstIteratorAttribute<T>(const_cast<char*>(reinterpret_cast<const char*>(column<T>(attributeName) + size())), sizeof(T));
+}
+
+} //namespace Lidar
+
+#endif /* LIDARCOLUMNARDATACONTAINER_H_ */
@@ -0,0 +1,147 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "LidarFormat/LidarDataAllocator.h"
+
+
+namespace Lidar
+{
+
+const std::size_t LidarDataAllocator::alignment;
+const std::size_t HugePageAllocator::hugePageSize;
+
+shared_ptr<LidarDataAllocator> LidarDataAllocator::defaultAllocator()
+{
+	static const shared_ptr<LidarDataAllocator> allocator(new AlignedHeapAllocator);
+	return allocator;
+}
+
+
+char* AlignedHeapAllocator::allocate(const std::size_t size)
+{
+	//the shift to the aligned address (1 to alignment bytes) is stored in the byte just before it
+	char* block = new char[size + alignment];
+	const std::size_t shift = alignment - reinterpret_cast<std::size_t>(block) % alignment;
+	char* data = block + shift;
+	data[-1] = static_cast<char>(shift);
+	return data;
+}
+
+void AlignedHeapAllocator::deallocate(char* data, const std::size_t /*size*/)
+{
+	if(data)
+		delete[] (data - static_cast<unsigned char>(data[-1]));
+}
+
+
+HugePageAllocator::HugePageAllocator(const bool useHugeTLB, const std::size_t minSize):
+	m_useHugeTLB(useHugeTLB), m_minSize(minSize)
+{
+}
+
+#ifdef __linux__
+
+namespace
+{
+	std::size_t mappedSize(const std::size_t size)
+	{
+		return (size + HugePageAllocator::hugePageSize - 1) / HugePageAllocator::hugePageSize * HugePageAllocator::hugePageSize;
+	}
+}
+
+char* HugePageAllocator::allocate(const std::size_t size)
+{
+	if(size < m_minSize || size == 0)
+		return AlignedHeapAllocator::allocate(size);
+
+	void* data = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+	//fails when not enough huge pages are reserved (/proc/sys/vm/nr_hugepages)
+	if(m_useHugeTLB)
+		data = mmap(0, mappedSize(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+
+	if(data == MAP_FAILED)
+	{
+		data = mmap(0, mappedSize(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if(data == MAP_FAILED)
+			throw std::bad_alloc();
+
+#ifdef MADV_HUGEPAGE
+		madvise(data, mappedSize(size), MADV_HUGEPAGE);
+#endif
+	}
+
+	return static_cast<char*>(data);
+}
+
+void HugePageAllocator::deallocate(char* data, const std::size_t size)
+{
+	if(size < m_minSize || size == 0)
+		AlignedHeapAllocator::deallocate(data, size);
+	else if(data)
+		munmap(data, mappedSize(size));
+}
+
+#else
+
+char* HugePageAllocator::allocate(const std::size_t size)
+{
+	return AlignedHeapAllocator::allocate(size);
+}
+
+void HugePageAllocator::deallocate(char* data, const std::size_t size)
+{
+	AlignedHeapAllocator::deallocate(data, size);
+}
+
+#endif
+
+} //namespace Lidar
@@ -0,0 +1,118 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef LIDARDATAALLOCATOR_H_
+#define LIDARDATAALLOCATOR_H_
+
+#include <cstddef>
+
+#include <boost/shared_ptr.hpp>
+
+
+namespace Lidar
+{
+
+using boost::shared_ptr;
+
+/**
+* @brief Allocation policy of the heap blocks of a LidarDataBuffer.
+*
+* Blocks are aligned on LidarDataAllocator::alignment bytes and their content is not initialized.
+* A buffer keeps a shared_ptr on its allocator: it may be shared by several containers.
+*
+*/
+
+class LidarDataAllocator
+{
+	public:
+		///Alignment of the blocks (a cache line, enough for any SIMD load)
+		static const std::size_t alignment = 64;
+
+		virtual ~LidarDataAllocator() {}
+
+		///Throws std::bad_alloc on failure
+		virtual char* allocate(const std::size_t size) = 0;
+		///size is the one given to allocate
+		virtual void deallocate(char* data, const std::size_t size) = 0;
+
+		///Allocator used by default by the buffers (an AlignedHeapAllocator)
+		static shared_ptr<LidarDataAllocator> defaultAllocator();
+};
+
+
+///Aligned blocks taken from the heap (new[])
+class AlignedHeapAllocator : public LidarDataAllocator
+{
+	public:
+		virtual char* allocate(const std::size_t size);
+		virtual void deallocate(char* data, const std::size_t size);
+};
+
+
+/**
+* @brief Blocks backed by huge pages, to reduce the TLB misses on clouds of several GB.
+*
+* Blocks of at least minSize bytes are mapped with mmap and advised as transparent huge pages
+* (madvise(MADV_HUGEPAGE)), or taken from the reserved huge pages (MAP_HUGETLB) when useHugeTLB is set
+* and some are available. Smaller blocks, and all blocks on systems other than Linux, come from the heap.
+*
+*/
+class HugePageAllocator : public AlignedHeapAllocator
+{
+	public:
+		///Size of a huge page on x86-64
+		static const std::size_t hugePageSize = 2*1024*1024;
+
+		explicit HugePageAllocator(const bool useHugeTLB = false, const std::size_t minSize = hugePageSize);
+
+		virtual char* allocate(const std::size_t size);
+		virtual void deallocate(char* data, const std::size_t size);
+
+	private:
+		bool m_useHugeTLB;
+		std::size_t m_minSize;
+};
+
+} //namespace Lidar
+
+#endif /* LIDARDATAALLOCATOR_H_ */
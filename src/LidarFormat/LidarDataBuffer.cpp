@@ -0,0 +1,372 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "LidarFormat/LidarDataBuffer.h"
+
+
+namespace Lidar
+{
+
+namespace
+{
+
+//deleters of the blocks given by releaseData
+struct AllocatorDeleter
+{
+	AllocatorDeleter(const shared_ptr<LidarDataAllocator>& allocator, const std::size_t capacity):
+		allocator_(allocator), capacity_(capacity) {}
+
+	void operator()(char* data) const
+	{
+		allocator_->deallocate(data, capacity_);
+	}
+
+	shared_ptr<LidarDataAllocator> allocator_;
+	std::size_t capacity_;
+};
+
+struct RegionDeleter
+{
+	explicit RegionDeleter(const shared_ptr<boost::interprocess::mapped_region>& region): region_(region) {}
+
+	void operator()(char*) const {}
+
+	shared_ptr<boost::interprocess::mapped_region> region_;
+};
+
+} //namespace
+
+const std::size_t LidarDataBuffer::alignment;
+
+LidarDataBuffer::LidarDataBuffer():
+	m_data(0), m_size(0), m_capacity(0), m_mappingMode(readOnly), m_allocator(LidarDataAllocator::defaultAllocator())
+{
+}
+
+LidarDataBuffer::LidarDataBuffer(const LidarDataBuffer& rhs):
+	m_data(0), m_size(0), m_capacity(0), m_mappingMode(readOnly), m_allocator(rhs.m_allocator)
+{
+	copy(rhs);
+}
+
+LidarDataBuffer& LidarDataBuffer::operator=(const LidarDataBuffer& rhs)
+{
+	if(this!=&rhs)
+		copy(rhs);
+
+	return *this;
+}
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+LidarDataBuffer::LidarDataBuffer(LidarDataBuffer&& rhs):
+	m_data(0), m_size(0), m_capacity(0), m_mappingMode(readOnly), m_allocator(rhs.m_allocator)
+{
+	swap(rhs);
+}
+
+LidarDataBuffer& LidarDataBuffer::operator=(LidarDataBuffer&& rhs)
+{
+	if(this!=&rhs)
+	{
+		release();
+		m_size = 0;
+		swap(rhs);
+	}
+
+	return *this;
+}
+#endif
+
+LidarDataBuffer::~LidarDataBuffer()
+{
+	release();
+}
+
+void LidarDataBuffer::copy(const LidarDataBuffer& rhs)
+{
+	//copies use the allocator of rhs
+	if(m_allocator != rhs.m_allocator)
+	{
+		release();
+		m_allocator = rhs.m_allocator;
+	}
+
+	//a read-only mapping is never modified: it can be shared instead of copied
+	if(rhs.isMapped() && !rhs.isWritable())
+	{
+		release();
+		m_region = rhs.m_region;
+		m_mappingMode = rhs.m_mappingMode;
+		m_data = rhs.m_data;
+		m_size = rhs.m_size;
+		m_capacity = rhs.m_capacity;
+		return;
+	}
+
+	if(isMapped() || m_capacity < rhs.m_size)
+	{
+		release();
+		m_data = allocate(rhs.m_size);
+		m_capacity = rhs.m_size;
+	}
+
+	if(rhs.m_size > 0)
+		std::memcpy(m_data, rhs.m_data, rhs.m_size);
+	m_size = rhs.m_size;
+}
+
+std::size_t LidarDataBuffer::max_size() const
+{
+	return static_cast<std::size_t>(std::numeric_limits<std::ptrdiff_t>::max());
+}
+
+std::size_t LidarDataBuffer::nextCapacity(const std::size_t size) const
+{
+	//geometric growth, so that repeated push_back stay amortized O(1)
+	return std::max(size, 2*m_capacity);
+}
+
+void LidarDataBuffer::resize(const std::size_t size)
+{
+	if(size > m_capacity)
+		reallocate(nextCapacity(size));
+	else if(size > m_size && !isWritable())
+		reallocate(m_capacity);
+
+	if(size > m_size)
+		std::memset(m_data + m_size, 0, size - m_size);
+
+	m_size = size;
+}
+
+void LidarDataBuffer::resizeUninitialized(const std::size_t size)
+{
+	if(size > m_capacity)
+		reallocate(nextCapacity(size));
+	else if(size > m_size && !isWritable())
+		reallocate(m_capacity);
+
+	m_size = size;
+}
+
+void LidarDataBuffer::reserve(const std::size_t capacity)
+{
+	if(capacity > m_capacity)
+		reallocate(capacity);
+}
+
+void LidarDataBuffer::clear()
+{
+	//a mapping cannot be reused for new data, the file is released
+	if(isMapped())
+		release();
+
+	m_size = 0;
+}
+
+void LidarDataBuffer::append(const char* first, const char* last)
+{
+	const std::size_t nbBytes = last - first;
+	const std::size_t newSize = m_size + nbBytes;
+
+	if(newSize > m_capacity || !isWritable())
+	{
+		//[first, last) may be inside the current block: copy it before releasing the block
+		const std::size_t newCapacity = nextCapacity(newSize);
+		char* newData = allocate(newCapacity);
+		if(m_size > 0)
+			std::memcpy(newData, m_data, m_size);
+		if(nbBytes > 0)
+			std::memcpy(newData + m_size, first, nbBytes);
+
+		const std::size_t size = m_size;
+		release();
+		m_data = newData;
+		m_capacity = newCapacity;
+		m_size = size;
+	}
+	else if(nbBytes > 0)
+		std::memmove(m_data + m_size, first, nbBytes);
+
+	m_size = newSize;
+}
+
+void LidarDataBuffer::erase(const std::size_t first, const std::size_t last)
+{
+	assert(first <= last && last <= m_size);
+
+	if(first == last)
+		return;
+
+	if(!isWritable())
+		reallocate(m_capacity);
+
+	std::memmove(m_data + first, m_data + last, m_size - last);
+	m_size -= last - first;
+}
+
+void LidarDataBuffer::swap(LidarDataBuffer& rhs)
+{
+	std::swap(m_data, rhs.m_data);
+	std::swap(m_size, rhs.m_size);
+	std::swap(m_capacity, rhs.m_capacity);
+	std::swap(m_mappingMode, rhs.m_mappingMode);
+	m_region.swap(rhs.m_region);
+	m_external.swap(rhs.m_external);
+	m_allocator.swap(rhs.m_allocator);
+}
+
+void LidarDataBuffer::setAllocator(const shared_ptr<LidarDataAllocator>& allocator)
+{
+	//a mapping or an adopted block is not allocated: the next heap block will come from the new allocator
+	if(!isMapped() && !isAdopted() && m_data)
+	{
+		char* newData = allocator->allocate(m_capacity);
+		if(m_size > 0)
+			std::memcpy(newData, m_data, m_size);
+		m_allocator->deallocate(m_data, m_capacity);
+		m_data = newData;
+	}
+
+	m_allocator = allocator;
+}
+
+void LidarDataBuffer::map(const std::string& fileName, const MappingMode mode, const std::size_t offset, const std::size_t size)
+{
+	release();
+	m_size = 0;
+
+	//an empty region cannot be mapped
+	if(size == 0)
+		return;
+
+	using namespace boost::interprocess;
+
+	try
+	{
+		file_mapping file(fileName.c_str(), read_only);
+		m_region = shared_ptr<mapped_region>(new mapped_region(file, mode==readOnly ? read_only : copy_on_write, offset, size));
+	}
+	catch(const interprocess_exception& e)
+	{
+		throw std::logic_error("Error in LidarDataBuffer::map : unable to map " + fileName + " (" + e.what() + ") !\n");
+	}
+
+	m_mappingMode = mode;
+	m_data = static_cast<char*>(m_region->get_address());
+	m_size = size;
+	m_capacity = size;
+}
+
+void LidarDataBuffer::adopt(const shared_ptr<char>& data, const std::size_t size, const std::size_t capacity)
+{
+	if(size > capacity)
+		throw std::logic_error("Error in LidarDataBuffer::adopt : size is greater than capacity !\n");
+	if(!data && capacity > 0)
+		throw std::logic_error("Error in LidarDataBuffer::adopt : null block !\n");
+
+	release();
+
+	m_external = data;
+	m_data = data.get();
+	m_size = size;
+	m_capacity = capacity;
+}
+
+shared_ptr<char> LidarDataBuffer::releaseData()
+{
+	shared_ptr<char> data;
+	if(isAdopted())
+		data = m_external;
+	else if(isMapped())
+		data = shared_ptr<char>(m_data, RegionDeleter(m_region));
+	else if(m_data)
+		data = shared_ptr<char>(m_data, AllocatorDeleter(m_allocator, m_capacity));
+
+	m_external.reset();
+	m_region.reset();
+	m_data = 0;
+	m_size = 0;
+	m_capacity = 0;
+
+	return data;
+}
+
+void LidarDataBuffer::reallocate(const std::size_t capacity)
+{
+	assert(capacity >= m_size);
+
+	char* newData = allocate(capacity);
+	if(m_size > 0)
+		std::memcpy(newData, m_data, m_size);
+
+	const std::size_t size = m_size;
+	release();
+	m_data = newData;
+	m_capacity = capacity;
+	m_size = size;
+}
+
+void LidarDataBuffer::release()
+{
+	if(isMapped())
+		m_region.reset();
+	else if(isAdopted())
+		m_external.reset();
+	else
+		m_allocator->deallocate(m_data, m_capacity);
+
+	m_data = 0;
+	m_capacity = 0;
+}
+
+} //namespace Lidar
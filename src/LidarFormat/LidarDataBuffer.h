@@ -0,0 +1,167 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef LIDARDATABUFFER_H_
+#define LIDARDATABUFFER_H_
+
+#include <string>
+#include <cstddef>
+
+#include <boost/config.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "LidarFormat/LidarDataAllocator.h"
+
+namespace boost
+{
+	namespace interprocess
+	{
+		class mapped_region;
+	}
+}
+
+
+namespace Lidar
+{
+
+using boost::shared_ptr;
+
+/**
+* @brief Raw storage of the echoes of a LidarDataContainer.
+*
+* Same interface as the std::vector<char> it replaces, but the bytes either live on the heap,
+* in a memory-mapped file or in a block adopted from the caller. A mapped buffer loads its pages lazily and shares them between
+* processes; it is never written back to the file. It is copied to the heap as soon as it has
+* to grow (and, for a read-only mapping, as soon as it has to be modified). An adopted block is
+* used in place until it has to grow, and then given back to its deleter.
+*
+*/
+
+class LidarDataBuffer
+{
+	public:
+		enum MappingMode
+		{
+			readOnly, ///< pages shared with the file, any write through data() is a segmentation fault
+			copyOnWrite ///< modified pages become private to the process
+		};
+
+		///Alignment of the heap blocks (a cache line, enough for any SIMD load)
+		static const std::size_t alignment = LidarDataAllocator::alignment;
+
+		LidarDataBuffer();
+		LidarDataBuffer(const LidarDataBuffer& rhs);
+		LidarDataBuffer& operator=(const LidarDataBuffer& rhs);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		///rhs is left empty
+		LidarDataBuffer(LidarDataBuffer&& rhs);
+		LidarDataBuffer& operator=(LidarDataBuffer&& rhs);
+#endif
+		~LidarDataBuffer();
+
+		char* data() { return m_data; }
+		const char* data() const { return m_data; }
+
+		std::size_t size() const { return m_size; }
+		std::size_t capacity() const { return m_capacity; }
+		std::size_t max_size() const;
+		bool empty() const { return m_size==0; }
+
+		///New bytes are set to 0 (like std::vector)
+		void resize(const std::size_t size);
+		///New bytes are not initialized: for loaders that overwrite the whole buffer
+		void resizeUninitialized(const std::size_t size);
+		void reserve(const std::size_t capacity);
+		void clear();
+
+		///[first, last) may point inside the buffer itself
+		void append(const char* first, const char* last);
+		///Positions in bytes
+		void erase(const std::size_t first, const std::size_t last);
+
+		void swap(LidarDataBuffer& rhs);
+
+		///Maps [offset, offset+size) of fileName in place of the current content
+		void map(const std::string& fileName, const MappingMode mode, const std::size_t offset, const std::size_t size);
+
+		///Takes the block data (capacity bytes, the first size ones are the content) in place of the current content, without copy
+		///  the block is given back to the deleter of data as soon as the buffer no longer uses it
+		void adopt(const shared_ptr<char>& data, const std::size_t size, const std::size_t capacity);
+		///Gives the current block to the caller (freed by the deleter of the returned pointer, null if there is no block)
+		///  the buffer is left empty ; a read-only mapping stays read-only
+		shared_ptr<char> releaseData();
+
+		bool isMapped() const { return m_region.get() != 0; }
+		bool isAdopted() const { return m_external.get() != 0; }
+		bool isWritable() const { return !m_region || m_mappingMode == copyOnWrite; }
+
+		///Heap blocks are taken from allocator from now on (the current content is moved to it)
+		///  copies of the buffer share its allocator
+		void setAllocator(const shared_ptr<LidarDataAllocator>& allocator);
+		const shared_ptr<LidarDataAllocator>& getAllocator() const { return m_allocator; }
+
+	private:
+		void copy(const LidarDataBuffer& rhs);
+
+		///Moves the content to a heap block of the given capacity (which must hold size())
+		void reallocate(const std::size_t capacity);
+		///Gives back the heap block or the mapping, data() becomes null
+		void release();
+
+		std::size_t nextCapacity(const std::size_t size) const;
+
+		char* allocate(const std::size_t size) { return m_allocator->allocate(size); }
+
+		char* m_data;
+		std::size_t m_size;
+		std::size_t m_capacity;
+
+		shared_ptr<boost::interprocess::mapped_region> m_region; //not null when the bytes are mapped
+		shared_ptr<char> m_external; //not null when the block is adopted
+		MappingMode m_mappingMode;
+		shared_ptr<LidarDataAllocator> m_allocator;
+};
+
+} //namespace Lidar
+
+#endif /* LIDARDATABUFFER_H_ */
@@ -44,6 +44,9 @@ Contributors:
 #include <stdexcept>
 #include <fstream>
 #include <algorithm>
+#include <cstring>
+#include <utility>
+#include <limits>
 
 #include <boost/bind.hpp>
 #include <boost/bind/placeholders.hpp>
@@ -52,6 +55,8 @@ Contributors:
 
 #include "LidarFormat/LidarDataFormatTypes.h"
 #include "apply.h"
+#include "LidarFormat/tools/ParallelFor.h"
+#include "LidarFormat/tools/RadixSort.h"
 
 #include "LidarDataContainer.h"
 
@@ -88,15 +93,14 @@ void LidarDataContainer::getAttributeList(std::vector<std::string> &liste) const
 
 
 LidarDataContainer::LidarDataContainer():
-	attributeMap_(new AttributeMapType)
+	attributeMap_(new AttributeMapType), pointSize_(0)
 {
 
 }
 
 LidarDataContainer::LidarDataContainer(const LidarDataContainer& rhs):
-	attributeMap_(new AttributeMapType)
+	lidarData_(rhs.lidarData_), attributeMap_(rhs.attributeMap_), pointSize_(rhs.pointSize_)
 {
-	copy(rhs);
 }
 
 LidarDataContainer& LidarDataContainer::operator=(const LidarDataContainer& rhs)
@@ -107,9 +111,32 @@ LidarDataContainer& LidarDataContainer::operator=(const LidarDataContainer& rhs)
 	return *this;
 }
 
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+LidarDataContainer::LidarDataContainer(LidarDataContainer&& rhs):
+	lidarData_(std::move(rhs.lidarData_)), attributeMap_(rhs.attributeMap_), pointSize_(rhs.pointSize_)
+{
+}
+
+LidarDataContainer& LidarDataContainer::operator=(LidarDataContainer&& rhs)
+{
+	lidarData_ = std::move(rhs.lidarData_);
+	attributeMap_ = rhs.attributeMap_;
+	pointSize_ = rhs.pointSize_;
+
+	return *this;
+}
+#endif
+
+void LidarDataContainer::swap(LidarDataContainer& rhs)
+{
+	lidarData_.swap(rhs.lidarData_);
+	attributeMap_.swap(rhs.attributeMap_);
+	std::swap(pointSize_, rhs.pointSize_);
+}
+
 void LidarDataContainer::copy(const LidarDataContainer& rhs)
 {
-	*attributeMap_ = *rhs.attributeMap_;
+	attributeMap_ = rhs.attributeMap_;
 
 	lidarData_ = rhs.lidarData_;
 	pointSize_ = rhs.pointSize_;
@@ -120,7 +147,30 @@ void LidarDataContainer::append(const LidarDataContainer& rhs)
 {
 //	assert(*rhs.attributeMap_ == *attributeMap_);
 
-	lidarData_.insert(lidarData_.end(), rhs.lidarData_.begin(), rhs.lidarData_.end());
+	lidarData_.append(rhs.rawData(), rhs.rawData() + rhs.lidarData_.size());
+}
+
+void LidarDataContainer::mapFile(const std::string& fileName, const std::size_t nbEchos, const LidarDataBuffer::MappingMode mode, const std::size_t offset)
+{
+	lidarData_.map(fileName, mode, offset, nbEchos*pointSize());
+}
+
+void LidarDataContainer::adoptData(const shared_ptr<char>& data, const std::size_t nbEchos)
+{
+	lidarData_.adopt(data, nbEchos*pointSize(), nbEchos*pointSize());
+}
+
+void LidarDataContainer::adoptData(const shared_ptr<char>& data, const std::size_t nbEchos, const AttributeListType& attributes)
+{
+	//the current echoes are dropped first : nothing to move when the attributes change
+	lidarData_.clear();
+
+	std::vector<std::string> names;
+	getAttributeList(names);
+	delAttributes(names);
+	addAttributes(attributes);
+
+	adoptData(data, nbEchos);
 }
 
 //struct FunctorAddAttributeParameters
@@ -170,37 +220,470 @@ bool LidarDataContainer::addAttribute(const std::string& attributeName, const En
 	if(attributeMap_->find(attributeName)!=attributeMap_->end())
 		return false;
 
+	addAttributes(AttributeListType(1, AttributeListType::value_type(attributeName, type)));
+	return true;
+}
+
+void LidarDataContainer::addAttributes(const AttributeListType& attributes, const unsigned int nbThreads)
+{
+	//les nouveaux attributs sont ajoutés à la fin de chaque écho
+	AttributeMapType newAttributeMap = *attributeMap_;
+	unsigned int newPointSize = pointSize_;
+
+	for(AttributeListType::const_iterator it = attributes.begin(); it != attributes.end(); ++it)
+	{
+		if(newAttributeMap.find(it->first) != newAttributeMap.end())
+			continue;
+
+		AttributesInfo infos;
+		infos.type = it->second;
+		infos.decalage = newPointSize;
+		newAttributeMap.push_back(AttributeMapType::value_type(it->first, infos));
+
+		newPointSize += apply<PointSizeFunctor, unsigned int>(it->second);
+	}
+
+	if(newAttributeMap.size() != attributeMap_->size())
+		changeAttributes(newAttributeMap, nbThreads);
+}
+
+bool LidarDataContainer::delAttribute(const std::string& attributeName)
+{
+	if(attributeMap_->find(attributeName)==attributeMap_->end())
+		return false;
+
+	delAttributes(std::vector<std::string>(1, attributeName));
+	return true;
+}
+
+void LidarDataContainer::delAttributes(const std::vector<std::string>& attributeNames, const unsigned int nbThreads)
+{
+	//les attributs restants sont tassés, dans le même ordre
+	AttributeMapType newAttributeMap;
+	unsigned int newPointSize = 0;
+
+	for(AttributeMapType::const_iterator it = attributeMap_->begin(); it != attributeMap_->end(); ++it)
+	{
+		if(std::find(attributeNames.begin(), attributeNames.end(), it->first) != attributeNames.end())
+			continue;
 
-	//calcul du nouveau décalage
-	unsigned int sizeLastAttribute=0;
+		AttributesInfo infos = it->second;
+		infos.decalage = newPointSize;
+		newAttributeMap.push_back(AttributeMapType::value_type(it->first, infos));
 
-	if(!attributeMap_->empty())
-		sizeLastAttribute = apply<PointSizeFunctor, unsigned int>(attributeMap_->back().second.type);
+		newPointSize += apply<PointSizeFunctor, unsigned int>(it->second.type);
+	}
+
+	if(newAttributeMap.size() != attributeMap_->size())
+		changeAttributes(newAttributeMap, nbThreads);
+}
 
-	//ajout de l'attribut dans les maps et mise à jour des décalages qui suivent l'attribut inséré
-	AttributesInfo infos;
-	infos.type = type;
-	if(!attributeMap_->empty())
+
+namespace
+{
+
+//bytes [destination, destination+size) of a new echo, copied from [source, source+size) of the old one or set to 0
+struct RelayoutSegment
+{
+	unsigned int source;
+	unsigned int destination;
+	unsigned int size;
+	bool isCopy;
+};
+
+struct RelayoutFunctor
+{
+	RelayoutFunctor(const char* source, char* destination, const unsigned int sourcePointSize, const unsigned int destinationPointSize, const std::vector<RelayoutSegment>& segments):
+		source_(source), destination_(destination), sourcePointSize_(sourcePointSize), destinationPointSize_(destinationPointSize), segments_(segments) {}
+
+	void operator()(const std::size_t first, const std::size_t last) const
 	{
-		infos.decalage = sizeLastAttribute + attributeMap_->back().second.decalage;
+		for(std::size_t i = first; i < last; ++i)
+		{
+			const char* source = source_ + i*sourcePointSize_;
+			char* destination = destination_ + i*destinationPointSize_;
+
+			for(std::vector<RelayoutSegment>::const_iterator it = segments_.begin(); it != segments_.end(); ++it)
+			{
+				if(it->isCopy)
+					std::memcpy(destination + it->destination, source + it->source, it->size);
+				else
+					std::memset(destination + it->destination, 0, it->size);
+			}
+		}
 	}
-	else
-		infos.decalage = sizeLastAttribute;
 
+	const char* source_;
+	char* destination_;
+	unsigned int sourcePointSize_;
+	unsigned int destinationPointSize_;
+	const std::vector<RelayoutSegment>& segments_;
+};
+
+} //namespace
 
-	attributeMap_->push_back(AttributeMapType::value_type(attributeName, infos));
+void LidarDataContainer::changeAttributes(const AttributeMapType& newAttributeMap, const unsigned int nbThreads)
+{
+	//segments of bytes to move, consecutive attributes merged
+	std::vector<RelayoutSegment> segments;
+	unsigned int newPointSize = 0;
 
+	for(AttributeMapType::const_iterator it = newAttributeMap.begin(); it != newAttributeMap.end(); ++it)
+	{
+		const unsigned int size = apply<PointSizeFunctor, unsigned int>(it->second.type);
+		const AttributeMapType::const_iterator itOld = attributeMap_->find(it->first);
+
+		RelayoutSegment segment;
+		segment.isCopy = itOld != attributeMap_->end();
+		segment.source = segment.isCopy ? itOld->second.decalage : 0;
+		segment.destination = it->second.decalage;
+		segment.size = size;
+
+		RelayoutSegment* last = segments.empty() ? 0 : &segments.back();
+		if(last && last->isCopy == segment.isCopy && last->destination + last->size == segment.destination
+				&& (!segment.isCopy || last->source + last->size == segment.source))
+			last->size += size;
+		else
+			segments.push_back(segment);
+
+		newPointSize = std::max(newPointSize, it->second.decalage + size);
+	}
 
-	//Mise à jour de la pointSize :
-	unsigned int sizeLastInsertedAttribute;
-	sizeLastInsertedAttribute = apply<PointSizeFunctor, unsigned int>(type);
-	pointSize_ = infos.decalage + sizeLastInsertedAttribute;
+	const std::size_t nbEchos = pointSize_ > 0 ? size() : 0;
 
+	if(nbEchos > 0)
+	{
+		//every byte is written by the segments
+		LidarDataContainerType newData;
+		newData.setAllocator(lidarData_.getAllocator());
+		newData.resizeUninitialized(nbEchos*newPointSize);
 
-	//TODO
-	///MAJ des données ! décalage des attributs + initialisation du nouvel attribut
+		parallelFor(0, nbEchos, RelayoutFunctor(lidarData_.data(), newData.data(), pointSize_, newPointSize, segments), nbThreads);
 
-	return true;
+		lidarData_.swap(newData);
+	}
+
+	//the old description may be shared with copies of the container: it is replaced, not modified
+	attributeMap_.reset(new AttributeMapType(newAttributeMap));
+	pointSize_ = newPointSize;
+}
+
+
+namespace
+{
+
+template<typename T>
+struct ExtractKeysFunctor
+{
+	ExtractKeysFunctor(const char* data, const unsigned int pointSize, const unsigned int decalage, uint64* keys, EchoIndexType* indices):
+		data_(data), pointSize_(pointSize), decalage_(decalage), keys_(keys), indices_(indices) {}
+
+	void operator()(const std::size_t first, const std::size_t last) const
+	{
+		for(std::size_t i = first; i < last; ++i)
+		{
+			T value;
+			std::memcpy(&value, data_ + i*pointSize_ + decalage_, sizeof(T));
+			keys_[i] = radixKey(value);
+			indices_[i] = static_cast<EchoIndexType>(i);
+		}
+	}
+
+	const char* data_;
+	unsigned int pointSize_, decalage_;
+	uint64* keys_;
+	EchoIndexType* indices_;
+};
+
+template<EnumLidarDataType T>
+struct ExtractKeysApplyFunctor
+{
+	void operator()(const char* data, const unsigned int pointSize, const unsigned int decalage, std::vector<uint64>& keys, std::vector<EchoIndexType>& indices, const unsigned int nbThreads)
+	{
+		parallelFor(0, keys.size(), ExtractKeysFunctor<typename LidarEnumTypeTraits<T>::type>(data, pointSize, decalage, &keys[0], &indices[0]), nbThreads);
+	}
+};
+
+struct GatherEchosFunctor
+{
+	GatherEchosFunctor(const char* source, char* destination, const unsigned int pointSize, const EchoIndexType* permutation):
+		source_(source), destination_(destination), pointSize_(pointSize), permutation_(permutation) {}
+
+	void operator()(const std::size_t first, const std::size_t last) const
+	{
+		for(std::size_t i = first; i < last; ++i)
+			std::memcpy(destination_ + i*pointSize_, source_ + permutation_[i]*pointSize_, pointSize_);
+	}
+
+	const char* source_;
+	char* destination_;
+	unsigned int pointSize_;
+	const EchoIndexType* permutation_;
+};
+
+} //namespace
+
+void LidarDataContainer::sortByAttribute(const std::string& attributeName, const unsigned int nbThreads, const bool inPlace)
+{
+	std::vector<EchoIndexType> permutation;
+	sortPermutation(attributeName, permutation, nbThreads);
+	applyPermutation(permutation, nbThreads, inPlace);
+}
+
+void LidarDataContainer::sortPermutation(const std::string& attributeName, std::vector<EchoIndexType>& permutation, const unsigned int nbThreads) const
+{
+	const AttributeMapType::const_iterator it = attributeMap_->find(attributeName);
+	if(it == attributeMap_->end())
+		throw std::logic_error("Error in LidarDataContainer::sortPermutation : attribute " + attributeName + " is not present !\n");
+
+	const std::size_t nbEchos = size();
+	if(nbEchos > static_cast<std::size_t>(std::numeric_limits<EchoIndexType>::max()))
+		throw std::logic_error("Error in LidarDataContainer::sortPermutation : too many echoes for EchoIndexType (see LIDARFORMAT_COMPACT_INDEX) !\n");
+
+	//keys extracted in a compact array, sorted with the indices of the echoes
+	std::vector<uint64> keys(nbEchos);
+	permutation.resize(nbEchos);
+	if(nbEchos == 0)
+		return;
+
+	apply<ExtractKeysApplyFunctor, void, const char*, const unsigned int, const unsigned int, std::vector<uint64>&, std::vector<EchoIndexType>&, const unsigned int>
+		(it->second.type, rawData(), pointSize_, it->second.decalage, keys, permutation, nbThreads);
+
+	radixSort(keys, permutation, nbThreads);
+}
+
+void LidarDataContainer::applyPermutation(const std::vector<EchoIndexType>& permutation, const unsigned int nbThreads, const bool inPlace)
+{
+	const std::size_t nbEchos = size();
+	if(permutation.size() != nbEchos)
+		throw std::logic_error("Error in LidarDataContainer::applyPermutation : the permutation does not have the size of the container !\n");
+
+	if(nbEchos == 0)
+		return;
+
+	//checked before moving anything: the container is left untouched if the argument is not a permutation
+	std::vector<bool> seen(nbEchos, false);
+	for(std::size_t i = 0; i < nbEchos; ++i)
+	{
+		const std::size_t index = permutation[i];
+		if(index >= nbEchos || seen[index])
+			throw std::logic_error("Error in LidarDataContainer::applyPermutation : the argument is not a permutation !\n");
+		seen[index] = true;
+	}
+
+	if(!inPlace)
+	{
+		//one gather pass into a new buffer
+		LidarDataContainerType newData;
+		newData.setAllocator(lidarData_.getAllocator());
+		newData.resizeUninitialized(nbEchos*pointSize_);
+
+		parallelFor(0, nbEchos, GatherEchosFunctor(lidarData_.data(), newData.data(), pointSize_, &permutation[0]), nbThreads);
+
+		lidarData_.swap(newData);
+		return;
+	}
+
+	//cycles of the permutation: one echo saved per cycle
+	std::vector<bool>& done = seen;
+	done.flip();
+	std::vector<char> echo(pointSize_);
+	char* data = rawData();
+
+	for(std::size_t start = 0; start < nbEchos; ++start)
+	{
+		if(done[start])
+			continue;
+
+		std::memcpy(&echo[0], data + start*pointSize_, pointSize_);
+		std::size_t i = start;
+
+		for(;;)
+		{
+			done[i] = true;
+			const std::size_t next = permutation[i];
+			if(next == start)
+				break;
+
+			std::memcpy(data + i*pointSize_, data + next*pointSize_, pointSize_);
+			i = next;
+		}
+
+		std::memcpy(data + i*pointSize_, &echo[0], pointSize_);
+	}
+}
+
+
+namespace
+{
+
+const std::size_t minSelectionChunkSize = 65536;
+
+struct SelectEchosFunctor
+{
+	SelectEchosFunctor(const detail::_LidarEchoSelector& selector, const LidarConstIteratorEcho& begin, char* mask, std::size_t* counts, const std::size_t chunkSize, const std::size_t size):
+		selector_(&selector), begin_(begin), mask_(mask), counts_(counts), chunkSize_(chunkSize), size_(size) {}
+
+	void operator()(const std::size_t first, const std::size_t last) const
+	{
+		for(std::size_t chunk = first; chunk < last; ++chunk)
+		{
+			const std::size_t from = chunk*chunkSize_;
+			const std::size_t nbEchos = std::min(size_, from + chunkSize_) - from;
+			counts_[chunk] = selector_->select(begin_ + static_cast<std::ptrdiff_t>(from), nbEchos, mask_ + from);
+		}
+	}
+
+	const detail::_LidarEchoSelector* selector_;
+	LidarConstIteratorEcho begin_;
+	char* mask_;
+	std::size_t* counts_;
+	std::size_t chunkSize_, size_;
+};
+
+///Packs the echoes that are not selected at the beginning of their chunk (by runs of consecutive echoes)
+struct PackChunkFunctor
+{
+	PackChunkFunctor(char* data, const unsigned int pointSize, const char* mask, const std::size_t chunkSize, const std::size_t size):
+		data_(data), pointSize_(pointSize), mask_(mask), chunkSize_(chunkSize), size_(size) {}
+
+	void operator()(const std::size_t first, const std::size_t last) const
+	{
+		for(std::size_t chunk = first; chunk < last; ++chunk)
+		{
+			const std::size_t end = std::min(size_, (chunk+1)*chunkSize_);
+			std::size_t destination = chunk*chunkSize_;
+			std::size_t i = destination;
+
+			while(i < end)
+			{
+				while(i < end && mask_[i])
+					++i;
+				const std::size_t runStart = i;
+				while(i < end && !mask_[i])
+					++i;
+
+				if(destination != runStart)
+					std::memmove(data_ + destination*pointSize_, data_ + runStart*pointSize_, (i - runStart)*pointSize_);
+				destination += i - runStart;
+			}
+		}
+	}
+
+	char* data_;
+	unsigned int pointSize_;
+	const char* mask_;
+	std::size_t chunkSize_, size_;
+};
+
+///Copies the selected echoes of each chunk from its offset in the destination
+struct CopyChunkFunctor
+{
+	CopyChunkFunctor(const char* source, char* destination, const unsigned int pointSize, const char* mask, const std::size_t chunkSize, const std::size_t size, const std::size_t* offsets):
+		source_(source), destination_(destination), pointSize_(pointSize), mask_(mask), chunkSize_(chunkSize), size_(size), offsets_(offsets) {}
+
+	void operator()(const std::size_t first, const std::size_t last) const
+	{
+		for(std::size_t chunk = first; chunk < last; ++chunk)
+		{
+			const std::size_t end = std::min(size_, (chunk+1)*chunkSize_);
+			std::size_t destination = offsets_[chunk];
+			std::size_t i = chunk*chunkSize_;
+
+			while(i < end)
+			{
+				while(i < end && !mask_[i])
+					++i;
+				const std::size_t runStart = i;
+				while(i < end && mask_[i])
+					++i;
+
+				std::memcpy(destination_ + destination*pointSize_, source_ + runStart*pointSize_, (i - runStart)*pointSize_);
+				destination += i - runStart;
+			}
+		}
+	}
+
+	const char* source_;
+	char* destination_;
+	unsigned int pointSize_;
+	const char* mask_;
+	std::size_t chunkSize_, size_;
+	const std::size_t* offsets_;
+};
+
+} //namespace
+
+void LidarDataContainer::selectEchos(const detail::_LidarEchoSelector& selector, std::vector<char>& mask, std::vector<std::size_t>& counts, std::size_t& chunkSize, const unsigned int nbThreads) const
+{
+	const std::size_t nbEchos = size();
+	const std::size_t nbChunks = std::max<std::size_t>(1, std::min<std::size_t>(nbThreads == 0 ? defaultNbThreads() : nbThreads, nbEchos / minSelectionChunkSize));
+	chunkSize = std::max<std::size_t>(1, (nbEchos + nbChunks - 1) / nbChunks);
+
+	mask.resize(nbEchos);
+	counts.assign(nbChunks, 0);
+
+	if(nbEchos > 0)
+		parallelFor(0, nbChunks, SelectEchosFunctor(selector, begin(), &mask[0], &counts[0], chunkSize, nbEchos), nbThreads, 1);
+}
+
+std::size_t LidarDataContainer::eraseSelected(const detail::_LidarEchoSelector& selector, const unsigned int nbThreads)
+{
+	const std::size_t nbEchos = size();
+	if(nbEchos == 0)
+		return 0;
+
+	std::vector<char> mask;
+	std::vector<std::size_t> counts;
+	std::size_t chunkSize;
+	selectEchos(selector, mask, counts, chunkSize, nbThreads);
+
+	parallelFor(0, counts.size(), PackChunkFunctor(rawData(), pointSize_, &mask[0], chunkSize, nbEchos), nbThreads, 1);
+
+	//packed chunks moved next to each other, in order
+	std::size_t nbKept = 0;
+	for(std::size_t chunk = 0; chunk < counts.size(); ++chunk)
+	{
+		const std::size_t from = chunk*chunkSize;
+		const std::size_t kept = std::min(nbEchos, from + chunkSize) - from - counts[chunk];
+		if(nbKept != from && kept > 0)
+			std::memmove(rawData(nbKept), rawData(from), kept*pointSize_);
+		nbKept += kept;
+	}
+
+	resize(nbKept);
+	return nbEchos - nbKept;
+}
+
+void LidarDataContainer::copySelected(const detail::_LidarEchoSelector& selector, LidarDataContainer& result, const unsigned int nbThreads) const
+{
+	std::vector<char> mask;
+	std::vector<std::size_t> counts;
+	std::size_t chunkSize;
+	selectEchos(selector, mask, counts, chunkSize, nbThreads);
+
+	//position of the first selected echo of each chunk in result
+	std::vector<std::size_t> offsets(counts.size());
+	std::size_t nbSelected = 0;
+	for(std::size_t chunk = 0; chunk < counts.size(); ++chunk)
+	{
+		offsets[chunk] = nbSelected;
+		nbSelected += counts[chunk];
+	}
+
+	LidarDataContainerType newData;
+	newData.setAllocator(lidarData_.getAllocator());
+	newData.resizeUninitialized(nbSelected*pointSize_);
+
+	if(nbSelected > 0)
+		parallelFor(0, counts.size(), CopyChunkFunctor(lidarData_.data(), newData.data(), pointSize_, &mask[0], chunkSize, size(), &offsets[0]), nbThreads, 1);
+
+	//result may be *this
+	const shared_ptr<AttributeMapType> attributeMap = attributeMap_;
+	const unsigned int pointSize = pointSize_;
+	result.lidarData_.swap(newData);
+	result.attributeMap_ = attributeMap;
+	result.pointSize_ = pointSize;
 }
 
 
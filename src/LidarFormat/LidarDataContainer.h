@@ -53,6 +53,7 @@ Contributors:
 //#include <map>
 #include <cassert>
 
+#include <boost/config.hpp>
 #include <boost/bind.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/shared_array.hpp>
@@ -60,6 +61,8 @@ Contributors:
 
 
 #include "LidarFormat/AttributesInfo.h"
+#include "LidarFormat/AttributeHandle.h"
+#include "LidarFormat/LidarDataBuffer.h"
 #include "LidarFormat/LidarIteratorAttribute.h"
 #include "LidarFormat/LidarIteratorEcho.h"
 #include "LidarFormat/LidarIteratorXYZ.h"
@@ -72,6 +75,53 @@ namespace Lidar
 
 using boost::shared_ptr;
 
+namespace detail
+{
+	///Evaluation of the predicate of eraseIf/copyIf on a range of echoes (virtual : the threads are handled in LidarDataContainer.cpp)
+	struct _LidarEchoSelector
+	{
+		virtual ~_LidarEchoSelector() {}
+		///mask[i] : predicate on the i-th echo from first ; returns the number of selected echoes
+		virtual std::size_t select(const LidarConstIteratorEcho& first, const std::size_t nbEchos, char* mask) const = 0;
+	};
+
+	template<typename Predicate>
+	struct _LidarEchoPredicateSelector : public _LidarEchoSelector
+	{
+		explicit _LidarEchoPredicateSelector(const Predicate& predicate): m_predicate(predicate) {}
+
+		virtual std::size_t select(const LidarConstIteratorEcho& first, const std::size_t nbEchos, char* mask) const
+		{
+			//one copy of the predicate per thread
+			Predicate predicate(m_predicate);
+			LidarConstIteratorEcho it(first);
+			std::size_t count = 0;
+			for(std::size_t i = 0; i < nbEchos; ++i, ++it)
+			{
+				mask[i] = predicate(it) ? 1 : 0;
+				count += mask[i];
+			}
+			return count;
+		}
+
+		Predicate m_predicate;
+	};
+
+	template<typename T, typename Predicate>
+	struct _LidarAttributePredicate
+	{
+		_LidarAttributePredicate(const AttributeHandle<T>& handle, const Predicate& predicate): m_handle(handle), m_predicate(predicate) {}
+
+		bool operator()(const LidarConstIteratorEcho& it)
+		{
+			return m_predicate(it.value(m_handle));
+		}
+
+		AttributeHandle<T> m_handle;
+		Predicate m_predicate;
+	};
+}
+
 
 class LidarDataContainer
 {
@@ -91,34 +141,38 @@ class LidarDataContainer
 	    typedef std::reverse_iterator<iterator>				reverse_iterator;
 
 
-		typedef unsigned int IndexType;
+		typedef std::size_t IndexType;
 
 
 		LidarDataContainer();
+		///Les copies partagent la description des attributs (elle est dupliquée quand l'une des copies la modifie)
 		LidarDataContainer(const LidarDataContainer&);
 		LidarDataContainer& operator=(const LidarDataContainer&);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		///The echoes are moved: rhs keeps its attributes but is left empty
+		LidarDataContainer(LidarDataContainer&& rhs);
+		LidarDataContainer& operator=(LidarDataContainer&& rhs);
+#endif
 
+		void swap(LidarDataContainer& rhs);
 
 
-//		template<typename T>
-//		void addAttribute(const std::string &name, const T initValue = 0);
-//
-//		void delAttribute(const std::string &name);
-
 
 		///Interface semblable au vector :
 		bool empty() const;
 		void push_back(const LidarEcho& echo);
 		void reserve(const std::size_t nbEchos);
 		void resize(const std::size_t nbEchos);
+		///Same as resize, but the new echoes are not initialized (for loaders that overwrite them)
+		void resizeUninitialized(const std::size_t nbEchos);
 		std::size_t capacity() const;
 		std::size_t size() const;
 		std::size_t max_size() const;
 
 		void append(const LidarDataContainer& rhs);
 
-		unsigned int erase(const unsigned int position);
-		unsigned int erase(const unsigned int first, const unsigned int last);
+		IndexType erase(const IndexType position);
+		IndexType erase(const IndexType first, const IndexType last);
 		LidarIteratorEcho erase(const LidarIteratorEcho& position);
 		LidarIteratorEcho erase(const LidarIteratorEcho& first, const LidarIteratorEcho& last);
 		template<typename T> LidarIteratorXYZ<T> erase(const LidarIteratorXYZ<T>& position);
@@ -130,8 +184,8 @@ class LidarDataContainer
 		void clear();
 
 
-		reference operator[](const unsigned int index);
-		const_reference operator[](const unsigned int index) const;
+		reference operator[](const IndexType index);
+		const_reference operator[](const IndexType index) const;
 
 
 //		template<typename TAttributeType> const TAttributeType& value( const std::string &attributeName, const IndexType index ) const;
@@ -148,6 +202,10 @@ class LidarDataContainer
 		template<typename T> LidarIteratorAttribute<T> endAttribute(const std::string &attributeName);
 		template<typename T> LidarConstIteratorAttribute<T> beginAttribute(const std::string &attributeName) const;
 		template<typename T> LidarConstIteratorAttribute<T> endAttribute(const std::string &attributeName) const;
+		template<typename T> LidarIteratorAttribute<T> beginAttribute(const AttributeHandle<T> &handle);
+		template<typename T> LidarIteratorAttribute<T> endAttribute(const AttributeHandle<T> &handle);
+		template<typename T> LidarConstIteratorAttribute<T> beginAttribute(const AttributeHandle<T> &handle) const;
+		template<typename T> LidarConstIteratorAttribute<T> endAttribute(const AttributeHandle<T> &handle) const;
 
 		template<typename T> LidarIteratorXYZ<T> beginXYZ();
 		template<typename T> LidarIteratorXYZ<T> endXYZ();
@@ -164,10 +222,38 @@ class LidarDataContainer
 		const_reverse_iterator rbegin() const;
 		const_reverse_iterator rend() const;
 
+		typedef std::vector<std::pair<std::string, EnumLidarDataType> > AttributeListType;
+
 		///Ajoute un attribut avec son type dans le container
 		///  ATTENTION : l'appel à cette fonction rend obsolète tous les itérateurs en cours, et rend incompatible les anciens LidarEcho avec les nouveaux
 		///  La fonction retourne false si l'attribut était déjà présent dans le container
+		///  Les échos déjà présents sont réorganisés, le nouvel attribut y vaut 0
 		bool addAttribute(const std::string& attributeName, const EnumLidarDataType type);
+		///Same as addAttribute for several attributes, with a single pass over the data (attributes already present are skipped)
+		///  nbThreads : number of threads moving the data (0 : one per core)
+		void addAttributes(const AttributeListType& attributes, const unsigned int nbThreads = 1);
+
+		///Removes an attribute and packs the echoes (same warning as addAttribute)
+		///  La fonction retourne false si l'attribut n'était pas présent dans le container
+		bool delAttribute(const std::string& attributeName);
+		void delAttributes(const std::vector<std::string>& attributeNames, const unsigned int nbThreads = 1);
+
+		///Stable sort of the echoes by the value of an attribute (parallel radix sort of the keys, then one pass over the echoes)
+		///  inPlace : the echoes are moved by following the cycles of the permutation, without a second buffer of echoes (slower)
+		void sortByAttribute(const std::string& attributeName, const unsigned int nbThreads = 1, const bool inPlace = false);
+		///Permutation that sorts the echoes by attributeName : the i-th echo of the sorted container is the echo permutation[i]
+		void sortPermutation(const std::string& attributeName, std::vector<EchoIndexType>& permutation, const unsigned int nbThreads = 1) const;
+		///The i-th echo becomes the echo permutation[i] (permutation of [0, size()), same options as sortByAttribute)
+		void applyPermutation(const std::vector<EchoIndexType>& permutation, const unsigned int nbThreads = 1, const bool inPlace = false);
+
+		///Erases the echoes for which predicate(const LidarConstIteratorEcho&) is true, in place, and returns their number
+		///  the predicate is evaluated in parallel (one copy per thread), then the echoes are packed in one pass
+		template<typename Predicate> std::size_t eraseIf(Predicate predicate, const unsigned int nbThreads = 1);
+		///Same as eraseIf with predicate(T value) on one attribute
+		template<typename T, typename Predicate> std::size_t eraseIf(const AttributeHandle<T>& handle, Predicate predicate, const unsigned int nbThreads = 1);
+		///Copies into result (same attributes) the echoes for which the predicate is true
+		template<typename Predicate> void copyIf(Predicate predicate, LidarDataContainer& result, const unsigned int nbThreads = 1) const;
+		template<typename T, typename Predicate> void copyIf(const AttributeHandle<T>& handle, Predicate predicate, LidarDataContainer& result, const unsigned int nbThreads = 1) const;
 
 		bool checkAttributeIsPresent(const std::string& attributeName);
 
@@ -180,8 +266,37 @@ class LidarDataContainer
 		void getAttributeList(std::vector<std::string> &liste) const;
 
 		///ATTENTION ! Renvoit un pointeur sur les données du conteneur... dangereux ! (utilisé par la classe LidarFile pour charger les données binaires en une fois)
-		char* rawData() { return &lidarData_.front(); }
-		const char* rawData() const { return &lidarData_.front(); }
+		char* rawData() { return lidarData_.data(); }
+		const char* rawData() const { return lidarData_.data(); }
+
+		///Maps nbEchos echoes stored from offset in a binary file, instead of reading them (the attributes must be set first)
+		///  ATTENTION : with LidarDataBuffer::readOnly, writing through iterators or rawData() is a segmentation fault
+		///  The file must not be rewritten (saveInPlace) while it is mapped
+		void mapFile(const std::string& fileName, const std::size_t nbEchos, const LidarDataBuffer::MappingMode mode = LidarDataBuffer::readOnly, const std::size_t offset = 0);
+		bool isMapped() const { return lidarData_.isMapped(); }
+
+		///Takes nbEchos packed echoes (layout of getAttributeMap(), as in rawData()) as storage of the container, without copy
+		///  the attributes must be set first (as for mapFile) ; the current echoes are dropped
+		///  data is freed by its deleter when the container no longer uses it (destruction, growth beyond nbEchos, new adoptData or mapFile...)
+		void adoptData(const shared_ptr<char>& data, const std::size_t nbEchos);
+		///Same, the attributes of the container are first replaced by attributes (packed in this order)
+		void adoptData(const shared_ptr<char>& data, const std::size_t nbEchos, const AttributeListType& attributes);
+		///Same, data is given back to deleter(data)
+		template<typename Deleter> void adoptData(char* data, const std::size_t nbEchos, Deleter deleter)
+		{
+			adoptData(shared_ptr<char>(data, deleter), nbEchos);
+		}
+		template<typename Deleter> void adoptData(char* data, const std::size_t nbEchos, Deleter deleter, const AttributeListType& attributes)
+		{
+			adoptData(shared_ptr<char>(data, deleter), nbEchos, attributes);
+		}
+		///Gives the echoes to the caller, without copy : size()*pointSize() bytes, freed by the deleter of the returned pointer
+		///  the container keeps its attributes and is left empty
+		shared_ptr<char> releaseData() { return lidarData_.releaseData(); }
+
+		///Allocation policy of the echoes (aligned heap blocks by default, see HugePageAllocator for big clouds)
+		void setAllocator(const shared_ptr<LidarDataAllocator>& allocator) { lidarData_.setAllocator(allocator); }
+		const shared_ptr<LidarDataAllocator>& getAllocator() const { return lidarData_.getAllocator(); }
 
 		const AttributeMapType& getAttributeMap() const { return *attributeMap_; }
 
@@ -190,21 +305,39 @@ class LidarDataContainer
 		///Attention !
 		void push_back(const char* echo);
 		///Attention !
-		const char* rawData(const unsigned int index) const { return rawData() + index*pointSize();}
-		char* rawData(const unsigned int index) { return rawData() + index*pointSize();}
+		const char* rawData(const IndexType index) const { return rawData() + index*pointSize();}
+		char* rawData(const IndexType index) { return rawData() + index*pointSize();}
 
 		unsigned int getDecalage(const std::string &attributeName) const
 		{
 			return attributeMap_->find(attributeName)->second.decalage;
 		}
 
+		///Typed handle on an attribute, to access it without name lookup (throws if the attribute is missing or of another type)
+		template<typename T> AttributeHandle<T> handle(const std::string &attributeName) const
+		{
+			return makeAttributeHandle<T>(*attributeMap_, attributeName);
+		}
+
 	private:
+		///the pipelines build their iterators on the shared attribute map (LidarPipeline.h)
+		friend struct detail::_PipelineAccess;
+
 		void copy(const LidarDataContainer& rhs);
 
+		///Replaces the attributes by newAttributeMap (offsets included) and moves the data accordingly, in one pass
+		///  attributes of newAttributeMap that are not in the container are set to 0
+		void changeAttributes(const AttributeMapType& newAttributeMap, const unsigned int nbThreads);
+
+		///eraseIf and copyIf : selection (mask and number of selected echoes per chunk), then compaction
+		void selectEchos(const detail::_LidarEchoSelector& selector, std::vector<char>& mask, std::vector<std::size_t>& counts, std::size_t& chunkSize, const unsigned int nbThreads) const;
+		std::size_t eraseSelected(const detail::_LidarEchoSelector& selector, const unsigned int nbThreads);
+		void copySelected(const detail::_LidarEchoSelector& selector, LidarDataContainer& result, const unsigned int nbThreads) const;
+
 
 		/////Structure interne
 		typedef char BaseType;
-		typedef std::vector<BaseType> LidarDataContainerType;
+		typedef LidarDataBuffer LidarDataContainerType;
 
 		LidarIteratorEcho createLidarIteratorEcho(char* data) const
 		{
@@ -223,7 +356,7 @@ class LidarDataContainer
 
 		///data
 		mutable LidarDataContainerType lidarData_;
-		shared_ptr<AttributeMapType> attributeMap_; //infos sur les attributs
+		shared_ptr<AttributeMapType> attributeMap_; //infos sur les attributs, jamais modifiées sur place (partagées entre copies)
 
 		unsigned int pointSize_;
 
@@ -237,7 +370,7 @@ class LidarDataContainer
 
 inline LidarEcho LidarDataContainer::createEcho() const
 {
-	return LidarEcho(pointSize(), boost::shared_array<BaseType>(new BaseType[pointSize()]).get(), attributeMap_);
+	return LidarEcho(pointSize(), attributeMap_);
 }
 
 //template<typename TAttributeType>
@@ -268,13 +401,37 @@ inline LidarIteratorAttribute<T> LidarDataContainer::endAttribute(const std::str
 template<typename T>
 inline LidarConstIteratorAttribute<T> LidarDataContainer::beginAttribute(const std::string &attributeName) const
 {
-	return LidarConstIteratorAttribute<T>(&lidarData_.front() + getDecalage(attributeName), pointSize());
+	return LidarConstIteratorAttribute<T>(lidarData_.data() + getDecalage(attributeName), pointSize());
 }
 
 template<typename T>
 inline LidarConstIteratorAttribute<T> LidarDataContainer::endAttribute(const std::string &attributeName) const
 {
-	return LidarConstIteratorAttribute<T>(&lidarData_.front() + pointSize()*size() + getDecalage(attributeName), pointSize());
+	return LidarConstIteratorAttribute<T>(lidarData_.data() + pointSize()*size() + getDecalage(attributeName), pointSize());
+}
+
+template<typename T>
+inline LidarIteratorAttribute<T> LidarDataContainer::beginAttribute(const AttributeHandle<T> &handle)
+{
+	return LidarIteratorAttribute<T>(rawData() + handle.decalage(), pointSize());
+}
+
+template<typename T>
+inline LidarIteratorAttribute<T> LidarDataContainer::endAttribute(const AttributeHandle<T> &handle)
+{
+	return LidarIteratorAttribute<T>(rawData(size()) + handle.decalage(), pointSize());
+}
+
+template<typename T>
+inline LidarConstIteratorAttribute<T> LidarDataContainer::beginAttribute(const AttributeHandle<T> &handle) const
+{
+	return LidarConstIteratorAttribute<T>(lidarData_.data() + handle.decalage(), pointSize());
+}
+
+template<typename T>
+inline LidarConstIteratorAttribute<T> LidarDataContainer::endAttribute(const AttributeHandle<T> &handle) const
+{
+	return LidarConstIteratorAttribute<T>(lidarData_.data() + pointSize()*size() + handle.decalage(), pointSize());
 }
 
 
@@ -294,13 +451,13 @@ inline LidarIteratorXYZ<T> LidarDataContainer::endXYZ()
 template<typename T>
 inline LidarConstIteratorXYZ<T> LidarDataContainer::beginXYZ() const
 {
-	return LidarConstIteratorXYZ<T>(&lidarData_.front() + getDecalage("x"), pointSize());
+	return LidarConstIteratorXYZ<T>(lidarData_.data() + getDecalage("x"), pointSize());
 }
 
 template<typename T>
 inline LidarConstIteratorXYZ<T> LidarDataContainer::endXYZ() const
 {
-	return LidarConstIteratorXYZ<T>(&lidarData_.front() + pointSize()*size() + getDecalage("x"), pointSize());
+	return LidarConstIteratorXYZ<T>(lidarData_.data() + pointSize()*size() + getDecalage("x"), pointSize());
 }
 
 
@@ -319,12 +476,12 @@ inline LidarIteratorEcho LidarDataContainer::end()
 
 inline LidarConstIteratorEcho LidarDataContainer::begin() const
 {
-	return createLidarConstIteratorEcho(&lidarData_.front());
+	return createLidarConstIteratorEcho(lidarData_.data());
 }
 
 inline LidarConstIteratorEcho LidarDataContainer::end() const
 {
-	return createLidarConstIteratorEcho(&lidarData_.front() + pointSize()*size());
+	return createLidarConstIteratorEcho(lidarData_.data() + pointSize()*size());
 }
 
 inline LidarDataContainer::reverse_iterator LidarDataContainer::rbegin()
@@ -372,14 +529,19 @@ inline void LidarDataContainer::resize(const std::size_t nbEchos)
 	lidarData_.resize(nbEchos*pointSize());
 }
 
+inline void LidarDataContainer::resizeUninitialized(const std::size_t nbEchos)
+{
+	lidarData_.resizeUninitialized(nbEchos*pointSize());
+}
+
 
-inline LidarDataContainer::reference LidarDataContainer::operator[](const unsigned int index)
+inline LidarDataContainer::reference LidarDataContainer::operator[](const IndexType index)
 {
 	return begin()[index];
 }
 
 
-inline LidarDataContainer::const_reference LidarDataContainer::operator[](const unsigned int index) const
+inline LidarDataContainer::const_reference LidarDataContainer::operator[](const IndexType index) const
 {
 	return begin()[index];
 }
@@ -398,10 +560,8 @@ inline void LidarDataContainer::push_back(const LidarEcho& echo)
 
 inline void LidarDataContainer::push_back(const char* echo)
 {
-	resize(size()+1);
-
-	//recopie de l'écho
-	memcpy(rawData() + (size()-1)*pointSize(), echo, pointSize());
+	//recopie de l'écho (qui peut pointer dans le conteneur lui-même)
+	lidarData_.append(echo, echo + pointSize());
 }
 
 inline void LidarDataContainer::reserve(const std::size_t nbEchos)
@@ -409,32 +569,32 @@ inline void LidarDataContainer::reserve(const std::size_t nbEchos)
 	lidarData_.reserve(nbEchos*pointSize());
 }
 
-inline unsigned int LidarDataContainer::erase(const unsigned int position)
+inline LidarDataContainer::IndexType LidarDataContainer::erase(const IndexType position)
 {
-	LidarDataContainerType::iterator erase_pos = lidarData_.erase(lidarData_.begin() + position*pointSize(), lidarData_.begin() + (position+1)*pointSize());
-	return  erase_pos - lidarData_.begin();
+	lidarData_.erase(position*pointSize(), (position+1)*pointSize());
+	return position;
 }
 
-inline unsigned int LidarDataContainer::erase(const unsigned int first, const unsigned int last)
+inline LidarDataContainer::IndexType LidarDataContainer::erase(const IndexType first, const IndexType last)
 {
-	LidarDataContainerType::iterator erase_pos = lidarData_.erase(lidarData_.begin() + first*pointSize(), lidarData_.begin() + last*pointSize());
-	return erase_pos - lidarData_.begin();
+	lidarData_.erase(first*pointSize(), last*pointSize());
+	return first;
 }
 
 inline LidarIteratorEcho LidarDataContainer::erase(const LidarIteratorEcho& position)
 {
 	const LidarIteratorEcho beg = begin();
-	const unsigned int index = position - beg;
-	const unsigned int pos_erase = erase(index);
+	const IndexType index = position - beg;
+	const IndexType pos_erase = erase(index);
 	return begin() + pos_erase;
 }
 
 inline LidarIteratorEcho LidarDataContainer::erase(const LidarIteratorEcho& first, const LidarIteratorEcho& last)
 {
 	const LidarIteratorEcho beg = begin();
-	const unsigned int indexFirst = first - beg;
-	const unsigned int indexLast = last - beg;
-	const unsigned int pos_erase = erase(indexFirst, indexLast);
+	const IndexType indexFirst = first - beg;
+	const IndexType indexLast = last - beg;
+	const IndexType pos_erase = erase(indexFirst, indexLast);
 	return begin() + pos_erase;
 }
 
@@ -442,8 +602,8 @@ template<typename T>
 inline LidarIteratorXYZ<T> LidarDataContainer::erase(const LidarIteratorXYZ<T>& position)
 {
 	const LidarIteratorXYZ<T> beg = beginXYZ<T>();
-	const unsigned int index = position - beg;
-	const unsigned int pos_erase = erase(index);
+	const IndexType index = position - beg;
+	const IndexType pos_erase = erase(index);
 	return beginXYZ<T>() + pos_erase;
 }
 
@@ -451,9 +611,9 @@ template<typename T>
 inline LidarIteratorXYZ<T> LidarDataContainer::erase(const LidarIteratorXYZ<T>& first, const LidarIteratorXYZ<T>& last)
 {
 	const LidarIteratorXYZ<T> beg = beginXYZ<T>();
-	const unsigned int indexFirst = first - beg;
-	const unsigned int indexLast = last - beg;
-	const unsigned int pos_erase = erase(indexFirst, indexLast);
+	const IndexType indexFirst = first - beg;
+	const IndexType indexLast = last - beg;
+	const IndexType pos_erase = erase(indexFirst, indexLast);
 	return beginXYZ<T>() + pos_erase;
 }
 
@@ -461,8 +621,8 @@ template<typename T>
 inline LidarIteratorAttribute<T> LidarDataContainer::erase(const LidarIteratorAttribute<T>& position)
 {
 	const LidarIteratorAttribute<T> beg = beginAttribute<T>();
-	const unsigned int index = position - beg;
-	const unsigned int pos_erase = erase(index);
+	const IndexType index = position - beg;
+	const IndexType pos_erase = erase(index);
 	return beginAttribute<T>() + pos_erase;
 }
 
@@ -470,12 +630,36 @@ template<typename T>
 inline LidarIteratorAttribute<T> LidarDataContainer::erase(const LidarIteratorAttribute<T>& first, const LidarIteratorAttribute<T>& last)
 {
 	const LidarIteratorAttribute<T> beg = beginAttribute<T>();
-	const unsigned int indexFirst = first - beg;
-	const unsigned int indexLast = last - beg;
-	const unsigned int pos_erase = erase(indexFirst, indexLast);
+	const IndexType indexFirst = first - beg;
+	const IndexType indexLast = last - beg;
+	const IndexType pos_erase = erase(indexFirst, indexLast);
 	return beginAttribute<T>() + pos_erase;
 }
 
+template<typename Predicate>
+inline std::size_t LidarDataContainer::eraseIf(Predicate predicate, const unsigned int nbThreads)
+{
+	return eraseSelected(detail::_LidarEchoPredicateSelector<Predicate>(predicate), nbThreads);
+}
+
+template<typename T, typename Predicate>
+inline std::size_t LidarDataContainer::eraseIf(const AttributeHandle<T>& handle, Predicate predicate, const unsigned int nbThreads)
+{
+	return eraseIf(detail::_LidarAttributePredicate<T, Predicate>(handle, predicate), nbThreads);
+}
+
+template<typename Predicate>
+inline void LidarDataContainer::copyIf(Predicate predicate, LidarDataContainer& result, const unsigned int nbThreads) const
+{
+	copySelected(detail::_LidarEchoPredicateSelector<Predicate>(predicate), result, nbThreads);
+}
+
+template<typename T, typename Predicate>
+inline void LidarDataContainer::copyIf(const AttributeHandle<T>& handle, Predicate predicate, LidarDataContainer& result, const unsigned int nbThreads) const
+{
+	copyIf(detail::_LidarAttributePredicate<T, Predicate>(handle, predicate), result, nbThreads);
+}
+
 inline bool LidarDataContainer::checkAttributeIsPresent(const std::string& attributeName)
 {
 	return !(attributeMap_->find(attributeName) == attributeMap_->end());
@@ -0,0 +1,183 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef LIDARDATACONTAINERT_H_
+#define LIDARDATACONTAINERT_H_
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <boost/shared_ptr.hpp>
+
+#include "LidarFormat/LidarDataContainer.h"
+
+namespace Lidar
+{
+
+/**
+* @brief Description of the attributes of a point structure (name, type and offset of each member)
+*
+* Filled by the static function Schema::describe(LidarSchemaDescription<Schema>&) :
+*   d.add("x", &Schema::x);
+*
+*/
+template<typename Schema>
+class LidarSchemaDescription
+{
+	public:
+		struct Attribute
+		{
+			std::string name;
+			EnumLidarDataType type;
+			unsigned int decalage;
+		};
+
+		typedef std::vector<Attribute> AttributeListType;
+
+		template<typename T>
+		void add(const std::string& name, T Schema::* member)
+		{
+			const Schema point = Schema();
+			Attribute attribute;
+			attribute.name = name;
+			attribute.type = LidarTypeTraits<T>::enum_type;
+			attribute.decalage = static_cast<unsigned int>(reinterpret_cast<const char*>(&(point.*member)) - reinterpret_cast<const char*>(&point));
+			m_attributes.push_back(attribute);
+		}
+
+		const AttributeListType& attributes() const { return m_attributes; }
+
+	private:
+		AttributeListType m_attributes;
+};
+
+
+/**
+* @brief Statically typed access to a LidarDataContainer whose echoes have a known layout
+*
+* Schema is a packed POD structure (one member per attribute, in the order of the container,
+* see #pragma pack(1)) with a static function describe(LidarSchemaDescription<Schema>&).
+* The layout is checked once at construction, then the echoes are accessed as an array of Schema :
+* member accesses are compiled with fixed offsets, without lookup in the AttributeMapType.
+*
+* The container is shared, not copied. ATTENTION : changing the attributes of the container afterwards
+* (addAttributes, delAttributes...) invalidates the typed container.
+*
+*/
+template<typename Schema>
+class LidarDataContainerT
+{
+	public:
+		typedef Schema				value_type;
+		typedef Schema*				iterator;
+		typedef const Schema*		const_iterator;
+		typedef Schema&				reference;
+		typedef const Schema&		const_reference;
+		typedef std::size_t			size_type;
+
+		///Throws if the echoes of container do not have the layout of Schema
+		explicit LidarDataContainerT(const boost::shared_ptr<LidarDataContainer>& container):
+			m_container(container)
+		{
+			checkSchema(*m_container);
+		}
+
+		///Adds the attributes of Schema to a container without attributes
+		static void initAttributes(LidarDataContainer& container)
+		{
+			LidarSchemaDescription<Schema> description;
+			Schema::describe(description);
+
+			LidarDataContainer::AttributeListType attributes;
+			for(typename LidarSchemaDescription<Schema>::AttributeListType::const_iterator it = description.attributes().begin(); it != description.attributes().end(); ++it)
+				attributes.push_back(LidarDataContainer::AttributeListType::value_type(it->name, it->type));
+
+			container.addAttributes(attributes);
+		}
+
+		///Checks that the echoes of container have the layout of Schema (throws otherwise)
+		static void checkSchema(const LidarDataContainer& container)
+		{
+			if(container.pointSize() != sizeof(Schema))
+				throw std::logic_error("Error in LidarDataContainerT::checkSchema : the size of the echoes is not the size of the schema (is the structure packed ?) !\n");
+
+			LidarSchemaDescription<Schema> description;
+			Schema::describe(description);
+
+			for(typename LidarSchemaDescription<Schema>::AttributeListType::const_iterator it = description.attributes().begin(); it != description.attributes().end(); ++it)
+			{
+				AttributeMapType::const_iterator itAttribute = container.getAttributeMap().find(it->name);
+
+				if(itAttribute == container.getAttributeMap().end())
+					throw std::logic_error("Error in LidarDataContainerT::checkSchema : attribute " + it->name + " is not present !\n");
+
+				if(itAttribute->second.type != it->type || itAttribute->second.decalage != it->decalage)
+					throw std::logic_error("Error in LidarDataContainerT::checkSchema : attribute " + it->name + " does not have the type or the position of the schema !\n");
+			}
+		}
+
+		bool empty() const { return m_container->empty(); }
+		std::size_t size() const { return m_container->size(); }
+
+		Schema* data() { return reinterpret_cast<Schema*>(m_container->rawData()); }
+		const Schema* data() const { return reinterpret_cast<const Schema*>(static_cast<const LidarDataContainer&>(*m_container).rawData()); }
+
+		iterator begin() { return data(); }
+		iterator end() { return data() + size(); }
+		const_iterator begin() const { return data(); }
+		const_iterator end() const { return data() + size(); }
+
+		Schema& operator[](const std::size_t index) { return data()[index]; }
+		const Schema& operator[](const std::size_t index) const { return data()[index]; }
+
+		const boost::shared_ptr<LidarDataContainer>& container() const { return m_container; }
+
+	private:
+		boost::shared_ptr<LidarDataContainer> m_container;
+};
+
+
+} //namespace Lidar
+
+#endif /* LIDARDATACONTAINERT_H_ */
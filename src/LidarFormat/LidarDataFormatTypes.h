@@ -47,6 +47,7 @@ Contributors:
 #include <boost/cstdint.hpp>
 
 #include "LidarFormat/models/format_me.hxx"
+#include "LidarFormat/LidarFormatOptions.h"
 
 
 namespace Lidar
@@ -63,6 +64,14 @@ typedef boost::uint64_t uint64;
 typedef float float32;
 typedef double float64;
 
+///Index of an echo as stored by the library (spatial indexation, index views)
+///  32 bits with LIDARFORMAT_COMPACT_INDEX (CMake option ENABLE_COMPACT_INDEX, recorded in LidarFormatOptions.h), for tiles of less than 4G echoes
+#ifdef LIDARFORMAT_COMPACT_INDEX
+typedef uint32 EchoIndexType;
+#else
+typedef uint64 EchoIndexType;
+#endif
+
 
 typedef cs::AttributeDataType LidarDataType;
 typedef LidarDataType::Value EnumLidarDataType;
@@ -0,0 +1,156 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef LIDARDATASLICE_H_
+#define LIDARDATASLICE_H_
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+#include <boost/shared_ptr.hpp>
+
+#include "LidarFormat/LidarDataContainer.h"
+
+namespace Lidar
+{
+
+/**
+* @brief Echoes [first, first+count) of a LidarDataContainer, without copy
+*
+* Same access functions as the container (iterators on echoes, attributes and XYZ, rawData for the views) ;
+* the container is kept alive by a shared_ptr. The slice must stay inside the container : resizing the
+* container so that it becomes smaller than the slice invalidates it.
+*
+*/
+class LidarDataSlice
+{
+	public:
+		typedef LidarEcho						value_type;
+		typedef std::size_t						size_type;
+		typedef LidarIteratorEcho				iterator;
+		typedef LidarConstIteratorEcho			const_iterator;
+		typedef LidarDataContainer::IndexType	IndexType;
+
+		LidarDataSlice(const shared_ptr<LidarDataContainer>& container, const std::size_t first, const std::size_t count):
+			m_container(container), m_first(first), m_count(count)
+		{
+			if(first + count > container->size())
+				throw std::logic_error("Error in LidarDataSlice : the slice is not inside the container !\n");
+		}
+
+		///All the echoes of the container
+		explicit LidarDataSlice(const shared_ptr<LidarDataContainer>& container):
+			m_container(container), m_first(0), m_count(container->size())
+		{
+		}
+
+		///Sub-slice, first relative to this slice
+		LidarDataSlice slice(const std::size_t first, const std::size_t count) const
+		{
+			if(first + count > m_count)
+				throw std::logic_error("Error in LidarDataSlice::slice : the slice is not inside the slice !\n");
+			return LidarDataSlice(m_container, m_first + first, count);
+		}
+
+		///nbSlices consecutive slices of (almost) the same size, covering the echoes of the container
+		static std::vector<LidarDataSlice> split(const shared_ptr<LidarDataContainer>& container, const std::size_t nbSlices)
+		{
+			std::vector<LidarDataSlice> slices;
+			const std::size_t size = container->size();
+			for(std::size_t i = 0; i < nbSlices; ++i)
+			{
+				const std::size_t first = size*i / nbSlices;
+				slices.push_back(LidarDataSlice(container, first, size*(i+1) / nbSlices - first));
+			}
+			return slices;
+		}
+
+		bool empty() const { return m_count == 0; }
+		std::size_t size() const { return m_count; }
+		///Index of the first echo in the container
+		std::size_t first() const { return m_first; }
+		const shared_ptr<LidarDataContainer>& container() const { return m_container; }
+
+		const unsigned int pointSize() const { return m_container->pointSize(); }
+		const AttributeMapType& getAttributeMap() const { return m_container->getAttributeMap(); }
+		unsigned int getDecalage(const std::string &attributeName) const { return m_container->getDecalage(attributeName); }
+		template<typename T> AttributeHandle<T> handle(const std::string &attributeName) const { return m_container->handle<T>(attributeName); }
+
+		char* rawData() { return m_container->rawData(m_first); }
+		const char* rawData() const { return constContainer().rawData(m_first); }
+		char* rawData(const IndexType index) { return m_container->rawData(m_first + index); }
+		const char* rawData(const IndexType index) const { return constContainer().rawData(m_first + index); }
+
+		///Itérateurs
+		iterator begin() { return m_container->begin() + m_first; }
+		iterator end() { return begin() + m_count; }
+		const_iterator begin() const { return constContainer().begin() + m_first; }
+		const_iterator end() const { return begin() + m_count; }
+
+		template<typename T> LidarIteratorAttribute<T> beginAttribute(const std::string &attributeName) { return m_container->beginAttribute<T>(attributeName) + m_first; }
+		template<typename T> LidarIteratorAttribute<T> endAttribute(const std::string &attributeName) { return beginAttribute<T>(attributeName) + m_count; }
+		template<typename T> LidarConstIteratorAttribute<T> beginAttribute(const std::string &attributeName) const { return constContainer().beginAttribute<T>(attributeName) + m_first; }
+		template<typename T> LidarConstIteratorAttribute<T> endAttribute(const std::string &attributeName) const { return beginAttribute<T>(attributeName) + m_count; }
+
+		template<typename T> LidarIteratorAttribute<T> beginAttribute(const AttributeHandle<T> &handle) { return m_container->beginAttribute(handle) + m_first; }
+		template<typename T> LidarIteratorAttribute<T> endAttribute(const AttributeHandle<T> &handle) { return beginAttribute(handle) + m_count; }
+		template<typename T> LidarConstIteratorAttribute<T> beginAttribute(const AttributeHandle<T> &handle) const { return constContainer().beginAttribute(handle) + m_first; }
+		template<typename T> LidarConstIteratorAttribute<T> endAttribute(const AttributeHandle<T> &handle) const { return beginAttribute(handle) + m_count; }
+
+		template<typename T> LidarIteratorXYZ<T> beginXYZ() { return m_container->beginXYZ<T>() + m_first; }
+		template<typename T> LidarIteratorXYZ<T> endXYZ() { return beginXYZ<T>() + m_count; }
+		template<typename T> LidarConstIteratorXYZ<T> beginXYZ() const { return constContainer().beginXYZ<T>() + m_first; }
+		template<typename T> LidarConstIteratorXYZ<T> endXYZ() const { return beginXYZ<T>() + m_count; }
+
+	private:
+		const LidarDataContainer& constContainer() const { return *m_container; }
+
+		shared_ptr<LidarDataContainer> m_container;
+		std::size_t m_first;
+		std::size_t m_count;
+};
+
+} //namespace Lidar
+
+#endif /* LIDARDATASLICE_H_ */
@@ -42,19 +42,36 @@ Contributors:
 #ifndef LIDARDATAVIEW_HPP_
 #define LIDARDATAVIEW_HPP_
 
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+
 #include "LidarFormat/LidarDataContainer.h"
+#include "LidarFormat/LidarSelection.h"
+#include "LidarFormat/tools/StridedCopy.h"
+#include "LidarFormat/tools/ConvertValues.h"
 #include <boost/iterator/permutation_iterator.hpp>
+#include <boost/iterator/transform_iterator.hpp>
 using namespace Lidar;
 
-template<typename AttType>
+//DataType : LidarDataContainer (offset = getDecalage, stride = pointSize)
+//  or LidarColumnarDataContainer (offset = getColumnOffset, stride = getStride)
+//  or LidarDataSlice (same as LidarDataContainer, restricted to the echoes of the slice)
+template<typename AttType, typename DataType = LidarDataContainer>
 class LidarDataAttView{
 
 	public :
 	 	typedef AttViewIterator<AttType> iterator;
-	 	LidarDataAttView(boost::shared_ptr<LidarDataContainer> data, unsigned int offset,unsigned int stride) :
+	 	LidarDataAttView(boost::shared_ptr<DataType> data, unsigned int offset,unsigned int stride) :
 	 		m_data_ptr(data),
 	 		m_att_offset(offset),
 	 		m_att_stride(stride) {}
+		///Interleaved data only (offset = handle.decalage(), stride = pointSize)
+	 	LidarDataAttView(boost::shared_ptr<DataType> data, const AttributeHandle<AttType>& handle) :
+	 		m_data_ptr(data),
+	 		m_att_offset(handle.decalage()),
+	 		m_att_stride(data->pointSize()) {}
 		iterator begin()
 			{
 				char * raw_begin_att=m_data_ptr->rawData() + m_att_offset;
@@ -62,13 +79,23 @@ class LidarDataAttView{
 			}
 		iterator end()
 			{
-				int size=m_data_ptr->size();
+				std::size_t size=m_data_ptr->size();
 				char * raw_end_data=m_data_ptr->rawData() + m_att_offset+m_att_stride*(size);
 				return iterator(raw_end_data, m_att_stride);
 			}
+		///Copies the values of the echoes [i, i+n) into a unit-stride array, for the kernels working on blocks
+		void load_block(std::size_t i, std::size_t n, AttType* values) const
+			{
+				gatherStrided(m_data_ptr->rawData() + m_att_offset + m_att_stride*i, m_att_stride, n, values);
+			}
+		///Copies values back into the echoes [i, i+n)
+		void store_block(std::size_t i, std::size_t n, const AttType* values)
+			{
+				scatterStrided(values, n, m_data_ptr->rawData() + m_att_offset + m_att_stride*i, m_att_stride);
+			}
 
 	private :
-		boost::shared_ptr<LidarDataContainer> m_data_ptr;
+		boost::shared_ptr<DataType> m_data_ptr;
 		unsigned int m_att_offset;
 		unsigned int m_att_stride;
 };
@@ -118,22 +145,20 @@ struct MakeViewProxyIterator<AttType,3>
 	    		);
 		}
 };
-template<typename AttType, int dim>
+template<typename AttType, int dim, typename DataType = LidarDataContainer>
 class LidarDataAttProxyView{
 
 	public :
 	 	typedef AttViewProxyIterator<AttType,dim> iterator;
-	 	LidarDataAttProxyView(boost::shared_ptr<LidarDataContainer> data, unsigned int stride, unsigned int offset0=0,
+	 	LidarDataAttProxyView(boost::shared_ptr<DataType> data, unsigned int stride, unsigned int offset0=0,
 	    		unsigned int offset1=0,
 	    		unsigned int offset2=0,
 	    		unsigned int offset3=0
 	    		)
 	      : m_data_ptr(data),m_att_stride(stride)
 		{
-	    	  if (dim >= 1) m_att_offsets[0] = offset0;
-	    	  if (dim >= 2) m_att_offsets[1] = offset1;
-	    	   if (dim >= 3) m_att_offsets[2] = offset2;
-	    	   if (dim >= 3) m_att_offsets[3] = offset3;
+	    	const unsigned int offsets[4] = {offset0, offset1, offset2, offset3};
+	    	for(int i=0; i<dim && i<4 ;i++){	m_att_offsets[i]=offsets[i];}
 		}
 		iterator begin()
 			{
@@ -142,13 +167,28 @@ class LidarDataAttProxyView{
 			}
 		iterator end()
 			{
-				int size=m_data_ptr->size();
+				std::size_t size=m_data_ptr->size();
 				char * raw_end_data=m_data_ptr->rawData()+m_att_stride*(size);
 				return make_iterator.make(raw_end_data, m_att_stride, m_att_offsets);
 			}
+		///Copies the attributes of the echoes [i, i+n) into one unit-stride array per attribute (null arrays are skipped)
+		void load_block(std::size_t i, std::size_t n, AttType* values0, AttType* values1=0, AttType* values2=0) const
+			{
+				AttType* values[3] = {values0, values1, values2};
+				char * raw_block=m_data_ptr->rawData()+m_att_stride*i;
+				for(int d=0; d<dim && d<3 ;d++)
+					if(values[d]) gatherStrided(raw_block + m_att_offsets[d], m_att_stride, n, values[d]);
+			}
+		void store_block(std::size_t i, std::size_t n, const AttType* values0, const AttType* values1=0, const AttType* values2=0)
+			{
+				const AttType* values[3] = {values0, values1, values2};
+				char * raw_block=m_data_ptr->rawData()+m_att_stride*i;
+				for(int d=0; d<dim && d<3 ;d++)
+					if(values[d]) scatterStrided(values[d], n, raw_block + m_att_offsets[d], m_att_stride);
+			}
 
 	private :
-		boost::shared_ptr<LidarDataContainer> m_data_ptr;
+		boost::shared_ptr<DataType> m_data_ptr;
 		unsigned int m_att_stride;
 		unsigned int m_att_offsets[dim];
 		MakeViewProxyIterator<AttType, dim> make_iterator;
@@ -158,25 +198,26 @@ class LidarDataAttProxyView{
 // Multiple value / single type  proxy view .
 //    examples : xy view, xyz view, xz view etc..
 //******************************************************
-template<typename AttType, int dim>
+template<typename AttType, int dim, typename DataType = LidarDataContainer>
 class LidarDataAttProxyIndexView{
 
 	public :
 	 	typedef AttViewProxyIterator<AttType,dim> element_iterator;
-	 	typedef std::vector<int>::iterator index_iterator;
+	 	typedef std::vector<EchoIndexType>::iterator index_iterator;
 	 	typedef boost::permutation_iterator< element_iterator, index_iterator > iterator;
+	 	typedef AttViewProxyPrefetchIterator<AttType, dim, index_iterator> prefetch_iterator;
+	 	///Indices prefetched ahead by default (enough to hide the latency of the memory)
+	 	static const unsigned int defaultPrefetchDistance = 16;
 
-	 	LidarDataAttProxyIndexView(boost::shared_ptr<LidarDataContainer> data,boost::shared_ptr<std::vector<int> > index, unsigned int stride, unsigned int offset0=0,
+	 	LidarDataAttProxyIndexView(boost::shared_ptr<DataType> data,boost::shared_ptr<std::vector<EchoIndexType> > index, unsigned int stride, unsigned int offset0=0,
 	    		unsigned int offset1=0,
 	    		unsigned int offset2=0,
 	    		unsigned int offset3=0
 	    		)
 	      : m_data_ptr(data),m_index_ptr(index),m_att_stride(stride)
 		{
-	    	  if (dim >= 1) m_att_offsets[0] = offset0;
-	    	  if (dim >= 2) m_att_offsets[1] = offset1;
-	    	   if (dim >= 3) m_att_offsets[2] = offset2;
-	    	   if (dim >= 3) m_att_offsets[3] = offset3;
+	    	const unsigned int offsets[4] = {offset0, offset1, offset2, offset3};
+	    	for(int i=0; i<dim && i<4 ;i++){	m_att_offsets[i]=offsets[i];}
 		}
 		iterator begin()
 			{
@@ -193,13 +234,257 @@ class LidarDataAttProxyIndexView{
 							//return make_iterator.make(raw_begin_att, m_att_stride,m_att_offsets);
 			return make_permutation_iterator( make_iterator.make(raw_begin_att, m_att_stride,m_att_offsets), m_index_ptr->end() );
 			}
+		///Same echoes as begin()/end(), the echo distance indices ahead is prefetched :
+		///  for indices scattered in a big container (neighbourhoods of a spatial index...)
+		prefetch_iterator prefetch_begin(unsigned int distance=defaultPrefetchDistance)
+			{
+				char * raw_data=m_data_ptr->rawData();
+				return prefetch_iterator(make_iterator.make(raw_data, m_att_stride,m_att_offsets), raw_data, m_att_stride, m_index_ptr->begin(), m_index_ptr->end(), distance);
+			}
+		prefetch_iterator prefetch_end()
+			{
+				char * raw_data=m_data_ptr->rawData();
+				return prefetch_iterator(make_iterator.make(raw_data, m_att_stride,m_att_offsets), raw_data, m_att_stride, m_index_ptr->end(), m_index_ptr->end(), 0);
+			}
+		///Sorts the indices, when the order of the echoes does not matter : they are then visited in the order of the data
+		///  the view works on its own copy, the index given to the constructor is not modified
+		void sort_indices()
+			{
+				boost::shared_ptr<std::vector<EchoIndexType> > sorted(new std::vector<EchoIndexType>(*m_index_ptr));
+				std::sort(sorted->begin(), sorted->end());
+				m_index_ptr = sorted;
+			}
+
+	private :
+		boost::shared_ptr<DataType> m_data_ptr;
+		boost::shared_ptr<std::vector<EchoIndexType> > m_index_ptr;
+		unsigned int m_att_stride;
+		unsigned int m_att_offsets[dim];
+		MakeViewProxyIterator<AttType, dim> make_iterator;
+};
+
+//*******************************************************
+// Multiple value / single type  proxy view on a selection of echoes.
+//    same as LidarDataAttProxyIndexView, with a bitmap instead of a vector of indices :
+//    the selected echoes are visited in increasing order
+//******************************************************
+template<typename AttType, int dim, typename DataType = LidarDataContainer>
+class LidarDataAttProxySelectionView{
+
+	public :
+	 	typedef AttViewProxyIterator<AttType,dim> element_iterator;
+	 	typedef LidarSelection::const_iterator selection_iterator;
+	 	typedef boost::permutation_iterator< element_iterator, selection_iterator > iterator;
+
+	 	LidarDataAttProxySelectionView(boost::shared_ptr<DataType> data,boost::shared_ptr<LidarSelection> selection, unsigned int stride, unsigned int offset0=0,
+	    		unsigned int offset1=0,
+	    		unsigned int offset2=0,
+	    		unsigned int offset3=0
+	    		)
+	      : m_data_ptr(data),m_selection_ptr(selection),m_att_stride(stride)
+		{
+	    	if(selection->size() != data->size())
+	    		throw std::logic_error("Error in LidarDataAttProxySelectionView : the selection and the data have different sizes !\n");
+	    	const unsigned int offsets[4] = {offset0, offset1, offset2, offset3};
+	    	for(int i=0; i<dim && i<4 ;i++){	m_att_offsets[i]=offsets[i];}
+		}
+		iterator begin()
+			{
+				char * raw_begin_att=m_data_ptr->rawData();
+				return make_permutation_iterator( make_iterator.make(raw_begin_att, m_att_stride,m_att_offsets), m_selection_ptr->begin() );
+			}
+		iterator end()
+			{
+				char * raw_begin_att=m_data_ptr->rawData();
+				return make_permutation_iterator( make_iterator.make(raw_begin_att, m_att_stride,m_att_offsets), m_selection_ptr->end() );
+			}
 
 	private :
-		boost::shared_ptr<LidarDataContainer> m_data_ptr;
-		boost::shared_ptr<std::vector<int> > m_index_ptr;
+		boost::shared_ptr<DataType> m_data_ptr;
+		boost::shared_ptr<LidarSelection> m_selection_ptr;
 		unsigned int m_att_stride;
 		unsigned int m_att_offsets[dim];
 		MakeViewProxyIterator<AttType, dim> make_iterator;
 };
 
+//*******************************************************
+// Multiple values / mixed types proxy view .
+//    example : LidarDataTupleView<boost::tuple<double, double, float, uint8> >
+//    for x, y, intensity and classification read in one pass
+//    (*it).get<K>() is a reference on the K-th attribute of the echo
+//******************************************************
+template<typename Tuple, int K = boost::tuples::length<Tuple>::value>
+struct TupleViewOffsets
+{
+	//offsets of the attributes names[0..K), checked against the types of Tuple
+	static void get(const AttributeMapType& attributeMap, const std::vector<std::string>& names, unsigned int* offsets)
+	{
+		TupleViewOffsets<Tuple, K-1>::get(attributeMap, names, offsets);
+		offsets[K-1] = makeAttributeHandle<typename boost::tuples::element<K-1, Tuple>::type>(attributeMap, names[K-1]).decalage();
+	}
+};
+
+template<typename Tuple>
+struct TupleViewOffsets<Tuple, 0>
+{
+	static void get(const AttributeMapType&, const std::vector<std::string>&, unsigned int*) {}
+};
+
+template<typename Tuple, typename DataType = LidarDataContainer>
+class LidarDataTupleView{
+
+	public :
+	 	typedef AttViewTupleIterator<Tuple> iterator;
+	 	static const int dim = boost::tuples::length<Tuple>::value;
+
+	 	///offsets : one per attribute, in the order of Tuple
+	 	LidarDataTupleView(boost::shared_ptr<DataType> data, const std::vector<unsigned int>& offsets, unsigned int stride)
+	 	  : m_data_ptr(data),m_att_stride(stride)
+		{
+	 		if(offsets.size() != static_cast<std::size_t>(dim))
+	 			throw std::logic_error("Error in LidarDataTupleView : wrong number of offsets !\n");
+	 		std::copy(offsets.begin(), offsets.end(), m_att_offsets);
+		}
+		///Interleaved data only : attributes by name, in the order of Tuple (throws if one is missing or of another type)
+	 	LidarDataTupleView(boost::shared_ptr<DataType> data, const std::vector<std::string>& names)
+	 	  : m_data_ptr(data),m_att_stride(data->pointSize())
+		{
+	 		if(names.size() != static_cast<std::size_t>(dim))
+	 			throw std::logic_error("Error in LidarDataTupleView : wrong number of attributes !\n");
+	 		TupleViewOffsets<Tuple>::get(data->getAttributeMap(), names, m_att_offsets);
+		}
+		iterator begin()
+			{
+				return iterator(m_data_ptr->rawData(), m_att_stride, m_att_offsets);
+			}
+		iterator end()
+			{
+				std::size_t size=m_data_ptr->size();
+				return iterator(m_data_ptr->rawData()+m_att_stride*size, m_att_stride, m_att_offsets);
+			}
+		///Copies the K-th attribute of the echoes [i, i+n) into a unit-stride array
+		template<int K> void load_block(std::size_t i, std::size_t n, typename boost::tuples::element<K, Tuple>::type* values) const
+			{
+				gatherStrided(m_data_ptr->rawData() + m_att_offsets[K] + m_att_stride*i, m_att_stride, n, values);
+			}
+		template<int K> void store_block(std::size_t i, std::size_t n, const typename boost::tuples::element<K, Tuple>::type* values)
+			{
+				scatterStrided(values, n, m_data_ptr->rawData() + m_att_offsets[K] + m_att_stride*i, m_att_stride);
+			}
+
+	private :
+		boost::shared_ptr<DataType> m_data_ptr;
+		unsigned int m_att_stride;
+		unsigned int m_att_offsets[dim];
+};
+
+//*******************************************************
+// Computed (virtual) attribute view .
+//    the value of an echo is f(element of the base view), computed on dereference :
+//    no storage and no extra pass over the data. Any view can be the base, a computed view included.
+//    example : height above the ground, from a LidarDataAttProxyView<double,3> on x, y, z and
+//    a functor double operator()(const ViewProxyElement<double,3>& xyz) const returning z - dtm(x, y)
+//******************************************************
+template<typename ValueType, typename BaseView, typename Functor>
+class LidarDataComputedView{
+
+	public :
+	 	typedef boost::transform_iterator<Functor, typename BaseView::iterator, ValueType, ValueType> iterator;
+
+	 	LidarDataComputedView(const BaseView& base, const Functor& f)
+	 	  : m_base(base), m_f(f) {}
+		iterator begin()
+			{
+				return iterator(m_base.begin(), m_f);
+			}
+		iterator end()
+			{
+				return iterator(m_base.end(), m_f);
+			}
+		///Computes the values of the echoes [i, i+n) into a unit-stride array, for the kernels working on blocks
+		void load_block(std::size_t i, std::size_t n, ValueType* values)
+			{
+				typename BaseView::iterator it = m_base.begin() + static_cast<std::ptrdiff_t>(i);
+				for(std::size_t k=0; k<n; ++k, ++it)
+					values[k] = m_f(*it);
+			}
+		BaseView& base() { return m_base; }
+
+	private :
+		BaseView m_base;
+		Functor m_f;
+};
+
+///makeComputedView<double>(view, f) : same as LidarDataComputedView<double, View, Functor>(view, f)
+template<typename ValueType, typename BaseView, typename Functor>
+LidarDataComputedView<ValueType, BaseView, Functor> makeComputedView(const BaseView& base, const Functor& f)
+{
+	return LidarDataComputedView<ValueType, BaseView, Functor>(base, f);
+}
+
+//*******************************************************
+// Type-converting view .
+//    an attribute stored as From, seen as To : static_cast<To>(value*scale + offset), computed in double
+//    examples : LidarDataConvertView<float, double> for float-only consumers (offset = -centre for the coordinates),
+//    LidarDataConvertView<float, uint16> with the scale of an intensity
+//******************************************************
+template<typename To, typename From>
+struct ConvertValue
+{
+	ConvertValue(double scale=1., double offset=0.): m_scale(scale), m_offset(offset) {}
+	To operator()(const From value) const { return static_cast<To>(value*m_scale + m_offset); }
+
+	double m_scale;
+	double m_offset;
+};
+
+template<typename To, typename From, typename DataType = LidarDataContainer>
+class LidarDataConvertView{
+
+	public :
+	 	typedef boost::transform_iterator<ConvertValue<To, From>, AttViewIterator<From>, To, To> iterator;
+	 	///Values converted by load_block at a time (From values gathered on the stack)
+	 	static const std::size_t blockSize = 256;
+
+	 	///att_offset and stride : as for LidarDataAttView<From, DataType>
+	 	LidarDataConvertView(boost::shared_ptr<DataType> data, unsigned int att_offset, unsigned int stride, double scale=1., double offset=0.)
+	 	  : m_view(data, att_offset, stride), m_convert(scale, offset) {}
+		///Interleaved data only
+	 	LidarDataConvertView(boost::shared_ptr<DataType> data, const AttributeHandle<From>& handle, double scale=1., double offset=0.)
+	 	  : m_view(data, handle), m_convert(scale, offset) {}
+		iterator begin()
+			{
+				return iterator(m_view.begin(), m_convert);
+			}
+		iterator end()
+			{
+				return iterator(m_view.end(), m_convert);
+			}
+		///Converted values of the echoes [i, i+n) into a unit-stride array, by blocks (gather, then SIMD conversion)
+		void load_block(std::size_t i, std::size_t n, To* values) const
+			{
+				From buffer[blockSize];
+				for(std::size_t k=0; k<n; k+=blockSize)
+				{
+					const std::size_t m = std::min(blockSize, n-k);
+					m_view.load_block(i+k, m, buffer);
+					convertValues(buffer, m, m_convert.m_scale, m_convert.m_offset, values+k);
+				}
+			}
+
+	private :
+		LidarDataAttView<From, DataType> m_view;
+		ConvertValue<To, From> m_convert;
+};
+
+//std::min takes blockSize by reference : it needs a definition
+template<typename To, typename From, typename DataType>
+const std::size_t LidarDataConvertView<To, From, DataType>::blockSize;
+
+#if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) && !defined(BOOST_NO_CXX11_TEMPLATE_ALIASES)
+///LidarDataMultiAttView<double, double, float, uint8> is LidarDataTupleView<boost::tuple<double, double, float, uint8> >
+template<typename... AttTypes>
+using LidarDataMultiAttView = LidarDataTupleView<boost::tuple<AttTypes...> >;
+#endif
+
 #endif /* LIDARDATAVIEW_HPP_ */
@@ -43,6 +43,7 @@ Contributors:
 #define LIDARDATAVIEWELEMENT_HPP_
 
 #include <boost/iterator/iterator_facade.hpp>
+#include <boost/tuple/tuple.hpp>
 
 template <typename AttType>
 class AttViewIterator
@@ -80,12 +81,12 @@ public:
 
     void decrement() { m_raw_data -=m_stride;}
 
-    void advance(int n) {m_raw_data += n*m_stride; }
+    void advance(std::ptrdiff_t n) {m_raw_data += n*static_cast<std::ptrdiff_t>(m_stride); }
 
- 	std::ptrdiff_t distance_to(AttViewIterator j)
+ 	std::ptrdiff_t distance_to(AttViewIterator j) const
  	{
  		assert(m_stride == j.m_stride);
-		return static_cast<std::ptrdiff_t >( (m_raw_data - j.m_raw_data) / m_stride);
+		return static_cast<std::ptrdiff_t >( (j.m_raw_data - m_raw_data) / m_stride);
 
 	}
 
@@ -116,7 +117,7 @@ class ViewProxyElement<AttType1 , 1>{
 		ViewProxyElement():value0(0){}
 		ViewProxyElement(AttType1* val0)
 			:value0(val0) {}
-		template<int K> AttType1 get(){
+		template<int K> AttType1 get() const{
 			return *value0;
 		}
 		template<int K> void set(AttType1 value){
@@ -137,7 +138,7 @@ class ViewProxyElement<AttType1 , 2>{
 				value[0]=val0;
 				value[1]=val1;
 			}
-		template<int K> AttType1 get(){
+		template<int K> AttType1 get() const{
 				return *(value[K]);
 		}
 		template<int K> void set(AttType1 value)
@@ -161,7 +162,7 @@ class ViewProxyElement<AttType1, 3>{
 				value[1]=val1;
 				value[2]=val2;
 			}
-		template<int K> AttType1 get(){
+		template<int K> AttType1 get() const{
 				return *(value[K]);
 		}
 		template<int K> void set(AttType1 value)
@@ -234,10 +235,8 @@ public :
 	    		)
 	      : m_raw_data(raw_data),m_stride(stride)
 		{
-	    	  if (dim >= 1) m_offsets[0] = offset0;
-	    	  if (dim >= 2) m_offsets[1] = offset1;
-	    	   if (dim >= 3) m_offsets[2] = offset2;
-	    	   if (dim >= 3) m_offsets[3] = offset3;
+	    	const unsigned int offsets[4] = {offset0, offset1, offset2, offset3};
+	    	for(int i=0; i<dim && i<4 ;i++){	m_offsets[i]=offsets[i];}
 		}
 
 	 private:
@@ -259,12 +258,12 @@ public :
 
 	    void decrement() { m_raw_data -=m_stride;}
 
-	    void advance(int n) {m_raw_data += n*m_stride; }
+	    void advance(std::ptrdiff_t n) {m_raw_data += n*static_cast<std::ptrdiff_t>(m_stride); }
 
-	 	std::ptrdiff_t distance_to(AttViewProxyIterator j)
+	 	std::ptrdiff_t distance_to(AttViewProxyIterator j) const
 	 	{
 	 		assert(m_stride == j.m_stride);
-			return static_cast<std::ptrdiff_t >( (m_raw_data - j.m_raw_data) / m_stride);
+			return static_cast<std::ptrdiff_t >( (j.m_raw_data - m_raw_data) / m_stride);
 
 		}
 
@@ -277,4 +276,168 @@ public :
     MakeViewProxyElement<AttType, dim> make_proxy;
 };
 
+//*******************************************************
+// software prefetch of the cache line at address (no-op if the compiler has no builtin)
+inline void prefetchEcho(const char* address)
+{
+#if defined(__GNUC__)
+	__builtin_prefetch(address);
+#else
+	(void)address;
+#endif
+}
+
+//*******************************************************
+// iterator on the echoes of an index (random access IndexIterator),
+// the echo distance indices ahead is prefetched at each step
+template <typename AttType, int dim, typename IndexIterator>
+class AttViewProxyPrefetchIterator
+  : public boost::iterator_facade<
+      AttViewProxyPrefetchIterator<AttType, dim, IndexIterator>
+      , ViewProxyElement<AttType, dim>
+      , boost::forward_traversal_tag
+      , ViewProxyElement<AttType, dim>
+      ,std::ptrdiff_t
+    >
+{
+public :
+		AttViewProxyPrefetchIterator()
+	      : m_raw_data(0), m_stride(0), m_distance(0) {}
+
+	    AttViewProxyPrefetchIterator(const AttViewProxyIterator<AttType, dim>& elements, char* raw_data, unsigned int stride,
+	    		IndexIterator index, IndexIterator index_end, unsigned int distance)
+	      : m_elements(elements), m_raw_data(raw_data), m_stride(stride), m_index(index), m_index_end(index_end), m_distance(distance)
+		{
+	    	//the first echoes are requested at once
+	    	for(IndexIterator it=m_index; it!=m_index_end && it-m_index<static_cast<std::ptrdiff_t>(m_distance); ++it)
+	    		prefetchEcho(m_raw_data + static_cast<std::size_t>(*it)*m_stride);
+		}
+
+	 private:
+	    friend class boost::iterator_core_access;
+
+	    void increment()
+	    {
+	    	++m_index;
+	    	if(m_index_end - m_index > static_cast<std::ptrdiff_t>(m_distance))
+	    		prefetchEcho(m_raw_data + static_cast<std::size_t>(m_index[m_distance])*m_stride);
+	    }
+
+	    bool equal(AttViewProxyPrefetchIterator const& other) const
+	    {
+	        return m_index == other.m_index;
+	    }
+
+	    ViewProxyElement<AttType, dim> dereference() const {
+	    	return *(m_elements + static_cast<std::ptrdiff_t>(*m_index));
+	    }
+
+	//*******************************************************
+	// private meber data
+    AttViewProxyIterator<AttType, dim> m_elements;
+    char* m_raw_data;
+    unsigned int m_stride;
+    IndexIterator m_index;
+    IndexIterator m_index_end;
+    unsigned int m_distance;
+};
+
+
+//************************************************************
+//***********************************************************
+// proxy element on attributes of mixed types
+//   Tuple : boost::tuple of the types of the attributes,
+//   for example boost::tuple<double, double, float, Lidar::uint8>
+//*********************************************************
+ //*******************************************************
+template<typename Tuple>
+class ViewTupleProxyElement{
+
+	public :
+		static const int dim = boost::tuples::length<Tuple>::value;
+
+		ViewTupleProxyElement():m_raw_data(0)
+			{
+				for(int i=0; i<dim ;i++){	m_offsets[i]=0;}
+			}
+		ViewTupleProxyElement(char* raw_data, const unsigned int* offsets)
+			:m_raw_data(raw_data)
+			{
+				for(int i=0; i<dim ;i++){	m_offsets[i]=offsets[i];}
+			}
+		///Reference on the K-th attribute of the echo
+		template<int K> typename boost::tuples::element<K, Tuple>::type& get() const{
+			return *reinterpret_cast<typename boost::tuples::element<K, Tuple>::type*>(m_raw_data+m_offsets[K]);
+		}
+		template<int K> void set(const typename boost::tuples::element<K, Tuple>::type& value) const
+		{
+			get<K>()=value;
+		}
+
+	private :
+	char* m_raw_data;
+	unsigned int m_offsets[dim];
+};
+
+//*******************************************************
+// iterator on the echoes, with proxy elements of mixed types
+template <typename Tuple>
+class AttViewTupleIterator
+  : public boost::iterator_facade<
+      AttViewTupleIterator<Tuple>
+      , ViewTupleProxyElement<Tuple>
+      , boost::random_access_traversal_tag
+      , ViewTupleProxyElement<Tuple>
+      ,std::ptrdiff_t
+    >
+{
+public :
+		static const int dim = boost::tuples::length<Tuple>::value;
+
+		AttViewTupleIterator()
+	      : m_raw_data(0), m_stride(0)
+	       {
+	    	for(int i=0; i<dim ;i++){	m_offsets[i]=0;}
+	       }
+
+	    ///offsets : dim offsets, in the order of Tuple
+	    AttViewTupleIterator(char* raw_data, unsigned int stride, const unsigned int* offsets)
+	      : m_raw_data(raw_data),m_stride(stride)
+		{
+	    	for(int i=0; i<dim ;i++){	m_offsets[i]=offsets[i];}
+		}
+
+	 private:
+	    friend class boost::iterator_core_access;
+
+		//*****************************************************
+		//implement the iterator random access façade interface
+	    void increment() { m_raw_data += m_stride; }
+
+	    bool equal(AttViewTupleIterator const& other) const
+	    {
+	        return ( (this->m_raw_data == other.m_raw_data) && (m_stride==other.m_stride));
+	    }
+
+	    ViewTupleProxyElement<Tuple> dereference() const {
+	    	return ViewTupleProxyElement<Tuple>(m_raw_data, m_offsets);
+	    }
+
+	    void decrement() { m_raw_data -=m_stride;}
+
+	    void advance(std::ptrdiff_t n) {m_raw_data += n*static_cast<std::ptrdiff_t>(m_stride); }
+
+	 	std::ptrdiff_t distance_to(AttViewTupleIterator const& j) const
+	 	{
+	 		assert(m_stride == j.m_stride);
+			return static_cast<std::ptrdiff_t >( (j.m_raw_data - m_raw_data) / static_cast<std::ptrdiff_t>(m_stride));
+		}
+
+	//*******************************************************
+	// private meber data
+    char* m_raw_data;
+    unsigned int m_stride;
+    unsigned int m_offsets[dim];
+};
+
 #endif /* LIDARDATAVIEWELEMENT_HPP_ */
@@ -53,27 +53,27 @@ namespace Lidar
 template<Lidar::EnumLidarDataType T>
 struct PrintFunctor
 {
-	void operator()(std::ostream &os, const LidarEcho &echo, const std::string &name)
+	void operator()(std::ostream &os, const LidarEcho &echo, const unsigned int decalage)
 	{
-		os << echo.value<typename Lidar::LidarEnumTypeTraits<T>::type>(name) << "\t" ;
+		os << echo.value<typename Lidar::LidarEnumTypeTraits<T>::type>(decalage) << "\t" ;
 	}
 };
 
 template<>
 struct PrintFunctor<LidarDataType::int8>
 {
-	void operator()(std::ostream &os, const LidarEcho &echo, const std::string &name)
+	void operator()(std::ostream &os, const LidarEcho &echo, const unsigned int decalage)
 	{
-		os << (int) echo.value<int8>(name) << "\t" ;
+		os << (int) echo.value<int8>(decalage) << "\t" ;
 	}
 };
 
 template<>
 struct PrintFunctor<LidarDataType::uint8>
 {
-	void operator()(std::ostream &os, const LidarEcho &echo, const std::string &name)
+	void operator()(std::ostream &os, const LidarEcho &echo, const unsigned int decalage)
 	{
-		os << (unsigned int) echo.value<uint8>(name) << "\t" ;
+		os << (unsigned int) echo.value<uint8>(decalage) << "\t" ;
 	}
 };
 
@@ -83,7 +83,7 @@ std::ostream& operator<<( std::ostream& os, const LidarEcho& echo )
 	for(AttributeMapType::const_iterator it = echo.attributeMap_->begin(); it != echo.attributeMap_->end(); ++it)
 	{
 		EnumLidarDataType type = it->second.type;
-		apply<PrintFunctor, void, std::ostream &, const LidarEcho &, const std::string &>(type, os, echo, it->first);
+		apply<PrintFunctor, void, std::ostream &, const LidarEcho &, const unsigned int>(type, os, echo, it->second.decalage);
 
 	}
 
@@ -47,11 +47,13 @@ Contributors:
 #include <string>
 #include <map>
 #include <iosfwd>
+#include <cstring>
 
 #include <boost/shared_ptr.hpp>
-#include <boost/shared_array.hpp>
+#include <boost/config.hpp>
 
 #include "LidarFormat/AttributesInfo.h"
+#include "LidarFormat/AttributeHandle.h"
 #include "LidarFormat/LidarDataFormatTypes.h"
 
 namespace Lidar
@@ -62,67 +64,117 @@ namespace Lidar
 *
 * @author Adrien Chauve
 *
+* Les échos d'au plus smallEchoSize octets sont stockés dans l'objet (pas d'allocation dynamique),
+* les plus gros sur le tas.
+*
 */
 
 using boost::shared_ptr;
 
+class LidarEchoRef;
 
 class LidarEcho
 {
 	public:
+		static const unsigned int smallEchoSize = 64;
+
 		explicit LidarEcho(const unsigned int size, const char *data, const shared_ptr<AttributeMapType> &attributeMap):
-			echoPtr_(new char[size]), size_(size), attributeMap_(attributeMap)
+			echoPtr_(0), size_(0), attributeMap_(attributeMap)
 		{
+			allocate(size);
 			update(data);
 		}
 
-		LidarEcho(const LidarEcho &rhs)
+		///Echo initialisé à 0
+		explicit LidarEcho(const unsigned int size, const shared_ptr<AttributeMapType> &attributeMap):
+			echoPtr_(0), size_(0), attributeMap_(attributeMap)
+		{
+			allocate(size);
+			memset(echoPtr_, 0, size_);
+		}
+
+		LidarEcho(const LidarEcho &rhs):
+			echoPtr_(0), size_(0)
 		{
 			copy(rhs);
 		}
 
-//		LidarEcho(const LidarEchoRef& echo);
+		///Copie de l'écho référencé (défini dans LidarIteratorEcho.h)
+		LidarEcho(const LidarEchoRef& echo);
 
 		LidarEcho &operator=(const LidarEcho &rhs)
 		{
-			copy(rhs);
+			if(this != &rhs)
+				copy(rhs);
 			return *this;
 		}
 
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		LidarEcho(LidarEcho&& rhs):
+			echoPtr_(0), size_(0)
+		{
+			move(rhs);
+		}
+
+		LidarEcho &operator=(LidarEcho&& rhs)
+		{
+			if(this != &rhs)
+				move(rhs);
+			return *this;
+		}
+#endif
+
+		~LidarEcho()
+		{
+			deallocate();
+		}
+
 		inline friend bool operator== (const LidarEcho &lhs, const LidarEcho &rhs)
 		{
 			assert(lhs.size_ == rhs.size_);
-			return memcmp(lhs.echoPtr_.get(), rhs.echoPtr_.get(), lhs.size_)==0;
+			return memcmp(lhs.echoPtr_, rhs.echoPtr_, lhs.size_)==0;
 		}
 
 		template<typename TAttributeType>
 		const TAttributeType value(const std::string &attributeName) const
 		{
-			char *ptr = echoPtr_.get() + getDecalage(attributeName);
+			char *ptr = echoPtr_ + getDecalage(attributeName);
 			return *reinterpret_cast<TAttributeType*>(ptr);
 		}
 
 		template<typename TAttributeType>
 		TAttributeType& value(const std::string &attributeName)
 		{
-			char *ptr = echoPtr_.get() + getDecalage(attributeName);
+			char *ptr = echoPtr_ + getDecalage(attributeName);
 			return *reinterpret_cast<TAttributeType*>(ptr);
 		}
 
 		template<typename TAttributeType>
 		const TAttributeType value(const unsigned int decalage) const
 		{
-			char *ptr = echoPtr_.get() + decalage;
+			char *ptr = echoPtr_ + decalage;
 			return *reinterpret_cast<TAttributeType*>(ptr);
 		}
 
 		template<typename TAttributeType>
 		TAttributeType& value(const unsigned int decalage)
 		{
-			char *ptr = echoPtr_.get() + decalage;
+			char *ptr = echoPtr_ + decalage;
 			return *reinterpret_cast<TAttributeType*>(ptr);
 		}
 
+		template<typename TAttributeType>
+		const TAttributeType value(const AttributeHandle<TAttributeType> &handle) const
+		{
+			return handle(const_cast<const char*>(echoPtr_));
+		}
+
+		template<typename TAttributeType>
+		TAttributeType& value(const AttributeHandle<TAttributeType> &handle)
+		{
+			return handle(echoPtr_);
+		}
+
 
 
 		Lidar::EnumLidarDataType getAttributeType(const std::string &attributeName) const
@@ -147,28 +199,74 @@ class LidarEcho
 		///Attention !!
 		const char* getRawData() const
 		{
-			return echoPtr_.get();
+			return echoPtr_;
+		}
+
+		bool isSmall() const
+		{
+			return size_ <= smallEchoSize;
 		}
+
 	protected:
-		boost::shared_array<char> echoPtr_; //donnees d'un echo
+		char *echoPtr_; //donnees d'un echo (smallEcho_.data ou tas)
 		unsigned int size_; //taille d'un echo
 
 		shared_ptr<AttributeMapType> attributeMap_;
 
+		union SmallEchoType
+		{
+			char data[smallEchoSize];
+			double alignDouble;
+			int64 alignInt;
+		} smallEcho_;
+
 		void update(const char * data)
 		{
-			memcpy(echoPtr_.get(), data, size_);
+			memcpy(echoPtr_, data, size_);
+		}
+
+		///Ne réalloue que si la taille change
+		void allocate(const unsigned int size)
+		{
+			if(echoPtr_ && size == size_)
+				return;
+
+			deallocate();
+			size_ = size;
+			echoPtr_ = isSmall() ? smallEcho_.data : new char[size_];
+		}
+
+		void deallocate()
+		{
+			if(echoPtr_ && !isSmall())
+				delete[] echoPtr_;
+			echoPtr_ = 0;
 		}
 
 		void copy(const LidarEcho& rhs)
 		{
-			size_ = rhs.size_;
-			echoPtr_ = boost::shared_array<char>(new char[size_]);
-			update(rhs.echoPtr_.get());
+			allocate(rhs.size_);
+			update(rhs.echoPtr_);
 			attributeMap_ = rhs.attributeMap_;
 		}
 
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		void move(LidarEcho& rhs)
+		{
+			if(rhs.isSmall())
+			{
+				copy(rhs);
+				return;
+			}
 
+			deallocate();
+			size_ = rhs.size_;
+			echoPtr_ = rhs.echoPtr_;
+			attributeMap_ = rhs.attributeMap_;
+			rhs.echoPtr_ = 0;
+			rhs.size_ = 0;
+		}
+#endif
 
 };
 
@@ -88,12 +88,12 @@ std::string LidarFile::getBinaryDataFileName() const
 	return path(m_xmlFileName).branch_path().string() + "/" + m_xmlData->attributes().dataFileName();
 }
 
-unsigned int LidarFile::getNbPoints() const
+std::size_t LidarFile::getNbPoints() const
 {
 	if(!isValid())
 		throw std::logic_error("Error : Lidar xml file is not valid !\n");
 
-	return (unsigned int)m_xmlData->attributes().dataSize();
+	return static_cast<std::size_t>(m_xmlData->attributes().dataSize());
 }
 
 LidarFile::LidarFile(const std::string &xmlFileName):
@@ -117,7 +117,7 @@ LidarFile::LidarFile(const std::string &xmlFileName):
 
 }
 
-void LidarFile::loadData(LidarDataContainer& lidarContainer)
+void LidarFile::loadData(LidarDataContainer& lidarContainer, const EnumLoadingMode mode)
 {
 	if(!isValid())
 		throw std::logic_error("Error : Lidar xml file is not valid !\n");
@@ -128,10 +128,21 @@ void LidarFile::loadData(LidarDataContainer& lidarContainer)
 	loadMetaDataFromXML();
 	setMapsFromXML(lidarContainer);
 
-	lidarContainer.resize(m_lidarMetaData.nbPoints_);
-
 	reader->setXMLData(m_xmlData);
+	reader->setReadOptions(m_readOptions);
+	m_readStatistics = ParallelReadStatistics();
+
+	if(mode != loadInMemory)
+	{
+		reader->mapData(lidarContainer, m_lidarMetaData, mode);
+		return;
+	}
+
+	//the reader writes every echo: no need to initialize them first
+	lidarContainer.resizeUninitialized(m_lidarMetaData.nbPoints_);
+
 	reader->loadData(lidarContainer, m_lidarMetaData, m_attributeMetaData);
+	m_readStatistics = reader->getReadStatistics();
 
 }
 
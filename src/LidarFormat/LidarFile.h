@@ -84,7 +84,7 @@ class LidarFile
 		///Récupère le nom du fichier de données
 		virtual std::string getBinaryDataFileName() const;
 		///Récupère le nb de points du nuage
-		virtual unsigned int getNbPoints() const;
+		virtual std::size_t getNbPoints() const;
 
 
 
@@ -92,7 +92,13 @@ class LidarFile
 		void loadTransfo(LidarCenteringTransfo& transfo) const;
 
 		///Charge les données du fichier dans un conteneur lidar
-		void loadData(LidarDataContainer& lidarContainer);
+		///  With mapReadOnly/mapCopyOnWrite, the binary file is mapped instead of read (see LidarDataContainer::mapFile)
+		void loadData(LidarDataContainer& lidarContainer, const EnumLoadingMode mode = loadInMemory);
+
+		///Options of the chunked parallel reads of the binary format (see readFileParallel)
+		void setReadOptions(const ParallelReadOptions& options) { m_readOptions = options; }
+		///Bytes read, time and throughput of the last loadData in memory (zero for the other formats)
+		const ParallelReadStatistics& getReadStatistics() const { return m_readStatistics; }
 
 		///Save container data in a file
 		static void save(const LidarDataContainer& lidarContainer, const std::string& xmlFileName, const LidarCenteringTransfo& transfo, const cs::DataFormatType format=cs::DataFormatType::binary);
@@ -122,6 +128,9 @@ class LidarFile
 		XMLLidarMetaData m_lidarMetaData;
 		XMLAttributeMetaDataContainerType m_attributeMetaData;
 
+		ParallelReadOptions m_readOptions;
+		ParallelReadStatistics m_readStatistics;
+
 		///fonctions utiles
 		///Chargement des méta-données à partir du xml
 		void loadMetaDataFromXML();
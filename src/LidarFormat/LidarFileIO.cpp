@@ -40,6 +40,8 @@ Contributors:
 ***********************************************************************/
 
 
+#include <stdexcept>
+
 #include "LidarFileIO.h"
 
 namespace Lidar
@@ -51,6 +53,17 @@ void LidarFileIO::setXMLData(const boost::shared_ptr<cs::LidarDataType>& xmlData
 	m_xmlData=xmlData;
 }
 
+void LidarFileIO::setReadOptions(const ParallelReadOptions& options)
+{
+	m_readOptions=options;
+}
+
+
+void LidarFileIO::mapData(LidarDataContainer& lidarContainer, const XMLLidarMetaData& lidarMetaData, const EnumLoadingMode mode)
+{
+	throw std::logic_error("Error in LidarFileIO::mapData : this file format cannot be mapped in memory !\n");
+}
+
 
 LidarFileIO::LidarFileIO()
 {
@@ -48,6 +48,7 @@ Contributors:
 #include <boost/shared_ptr.hpp>
 
 #include "LidarFormat/LidarDataFormatTypes.h"
+#include "LidarFormat/tools/ParallelFileReader.h"
 
 namespace Lidar
 {
@@ -77,6 +78,14 @@ struct XMLAttributeMetaData
 };
 typedef std::vector<XMLAttributeMetaData> XMLAttributeMetaDataContainerType;
 
+///How LidarFile::loadData brings the data in a container
+enum EnumLoadingMode
+{
+	loadInMemory, ///< data read in memory (all formats)
+	mapReadOnly, ///< file mapped in memory: pages loaded lazily and shared between processes
+	mapCopyOnWrite ///< file mapped in memory, modifications stay private to the container and are never written to the file
+};
+
 
 class LidarFileIO
 {
@@ -86,13 +95,23 @@ class LidarFileIO
 		virtual void loadData(LidarDataContainer& lidarContainer, const XMLLidarMetaData& lidarMetaData, const XMLAttributeMetaDataContainerType& attributesDescritpion)=0;
 		virtual void save(const LidarDataContainer& lidarContainer, const std::string& binaryDataFileName)=0;
 
+		///Maps the data file instead of reading it; only the formats storing raw echoes can do it (throws otherwise)
+		virtual void mapData(LidarDataContainer& lidarContainer, const XMLLidarMetaData& lidarMetaData, const EnumLoadingMode mode);
+
 
 		void setXMLData(const boost::shared_ptr<cs::LidarDataType>& xmlData);
 
+		///Options of the chunked parallel reads (formats reading raw echoes only)
+		void setReadOptions(const ParallelReadOptions& options);
+		///Statistics of the last loadData (zero for the formats which do not use readFileParallel)
+		const ParallelReadStatistics& getReadStatistics() const { return m_readStatistics; }
+
 	protected:
 		LidarFileIO();
 
 		boost::shared_ptr<cs::LidarDataType> m_xmlData;
+		ParallelReadOptions m_readOptions;
+		ParallelReadStatistics m_readStatistics;
 
 };
 
@@ -44,6 +44,7 @@ Contributors:
 #define LIDARITERATORATTRIBUTE_H_
 
 #include <string>
+#include <cstddef>
 #include <cassert>
 #include <iterator>
 
@@ -104,7 +105,7 @@ namespace detail
 
 			void incremente(const typename std::iterator<std::random_access_iterator_tag, T>::difference_type i)
 			{
-				m_dataPtr += m_increment * i;
+				m_dataPtr += static_cast<std::ptrdiff_t>(m_increment) * i;
 			}
 
 			void decremente()
@@ -203,7 +204,7 @@ class LidarIteratorAttribute : public detail::_LidarIteratorAttributeBase<T>
 		inline friend const difference_type operator- (const Self &lhs, const Self &rhs)
 		{
 			assert(lhs.m_increment == rhs.m_increment);
-			return static_cast<difference_type>( (lhs.m_dataPtr - rhs.m_dataPtr) / lhs.m_increment);
+			return (lhs.m_dataPtr - rhs.m_dataPtr) / static_cast<difference_type>(lhs.m_increment);
 		}
 
 		inline friend const Self operator+(const difference_type n, const Self& rhs)
@@ -299,7 +300,7 @@ class LidarConstIteratorAttribute : public detail::_LidarIteratorAttributeBase<T
 		inline friend const difference_type operator- (const Self &lhs, const Self &rhs)
 		{
 			assert(lhs.m_increment == rhs.m_increment);
-			return static_cast<difference_type>( (lhs.m_dataPtr - rhs.m_dataPtr) / lhs.m_increment);
+			return (lhs.m_dataPtr - rhs.m_dataPtr) / static_cast<difference_type>(lhs.m_increment);
 		}
 
 		inline friend const Self operator+(const difference_type n, const Self& rhs)
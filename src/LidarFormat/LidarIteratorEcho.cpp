@@ -52,18 +52,31 @@ knowledge of the CeCILL-B license and that you accept its terms.
 
 
 
-#include <iostream>
+#include <algorithm>
+#include <cstring>
 
 #include "LidarIteratorEcho.h"
 
 
-void swap(Lidar::detail::_LidarEchoProxy p1, Lidar::detail::_LidarEchoProxy p2)
+namespace Lidar
 {
-	using namespace Lidar;
 
-	LidarEcho temp(p1);
-	p1 = p2;
-	p2 = temp;
-
-	std::cout << "called \n" << std::endl;
+void swap(LidarEchoRef lhs, LidarEchoRef rhs)
+{
+	assert(lhs.size() == rhs.size());
+
+	char buffer[LidarEcho::smallEchoSize];
+	char *ptrLhs = lhs.getRawData();
+	char *ptrRhs = rhs.getRawData();
+
+	//par morceaux de smallEchoSize octets, pour ne pas allouer de tampon pour les gros échos
+	for(std::size_t done = 0; done < lhs.size(); done += sizeof(buffer))
+	{
+		const std::size_t n = std::min<std::size_t>(sizeof(buffer), lhs.size() - done);
+		memcpy(buffer, ptrLhs + done, n);
+		memcpy(ptrLhs + done, ptrRhs + done, n);
+		memcpy(ptrRhs + done, buffer, n);
+	}
 }
+
+} //namespace Lidar
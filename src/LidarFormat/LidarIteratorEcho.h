@@ -56,47 +56,106 @@ namespace Lidar
 
 using boost::shared_ptr;
 
-namespace detail
+/**
+ * Référence non propriétaire sur un écho d'un conteneur (renvoyée par LidarIteratorEcho::operator*)
+ *   l'affectation copie les octets de l'écho, la conversion en LidarEcho fait une copie (sans allocation pour les petits échos)
+ */
+class LidarEchoRef
 {
-	struct _LidarEchoProxy
-	{
-		_LidarEchoProxy(char *dataPtr, const std::size_t increment, const shared_ptr<AttributeMapType>& attributeMap):
+	public:
+		LidarEchoRef(char *dataPtr, const std::size_t increment, const shared_ptr<AttributeMapType>& attributeMap):
 			m_dataPtr(dataPtr), m_increment(increment), m_attributeMap(attributeMap)
 		{
 		}
 
-		_LidarEchoProxy():
-			m_dataPtr(0), m_increment(0), m_attributeMap(new AttributeMapType)
+		LidarEchoRef():
+			m_dataPtr(0), m_increment(0)
+		{
+		}
+
+		///La copie référence le même écho (seule l'affectation copie les octets)
+		LidarEchoRef(const LidarEchoRef& rhs):
+			m_dataPtr(rhs.m_dataPtr), m_increment(rhs.m_increment), m_attributeMap(rhs.m_attributeMap)
 		{
 		}
 
-		_LidarEchoProxy& operator=(const _LidarEchoProxy& rhs)
+		LidarEchoRef& operator=(const LidarEchoRef& rhs)
 		{
 			memcpy(m_dataPtr, rhs.m_dataPtr, m_increment);
 			return *this;
 		}
 
-		_LidarEchoProxy& operator=(const LidarEcho& rhs)
+		LidarEchoRef& operator=(const LidarEcho& rhs)
 		{
 			memcpy(m_dataPtr, rhs.getRawData(), m_increment);
 			return *this;
 		}
 
 	    bool
-	    operator==(const _LidarEchoProxy& rhs) const
+	    operator==(const LidarEchoRef& rhs) const
 	    {
-	    	return LidarEcho(*this) == LidarEcho(rhs);
+	    	assert(m_increment == rhs.m_increment);
+	    	return memcmp(m_dataPtr, rhs.m_dataPtr, m_increment)==0;
 	    }
 
-		operator LidarEcho() const
+		template<typename TAttributeType>
+		TAttributeType& value(const std::string &attributeName) const
 		{
-			return LidarEcho(m_increment, m_dataPtr, m_attributeMap);
+			return *reinterpret_cast<TAttributeType*>(m_dataPtr + getDecalage(attributeName));
 		}
 
+		template<typename TAttributeType>
+		TAttributeType& value(const unsigned int decalage) const
+		{
+			return *reinterpret_cast<TAttributeType*>(m_dataPtr + decalage);
+		}
+
+		template<typename TAttributeType>
+		TAttributeType& value(const AttributeHandle<TAttributeType> &handle) const
+		{
+			return handle(m_dataPtr);
+		}
+
+		unsigned int getDecalage(const std::string &attributeName) const
+		{
+			return m_attributeMap->find(attributeName)->second.decalage;
+		}
+
+		unsigned int size() const { return m_increment; }
+		char* getRawData() const { return m_dataPtr; }
+		const shared_ptr<AttributeMapType>& getAttributeMapPtr() const { return m_attributeMap; }
+
+	private:
+		char *m_dataPtr;
+		std::size_t m_increment;
+		shared_ptr<AttributeMapType> m_attributeMap; //infos sur les attributs
+};
+
+///Echange les octets de deux échos (utilisé par les algorithmes de la STL, sans allocation)
+void swap(LidarEchoRef lhs, LidarEchoRef rhs);
+
+inline LidarEcho::LidarEcho(const LidarEchoRef& echo):
+	echoPtr_(0), size_(0), attributeMap_(echo.getAttributeMapPtr())
+{
+	allocate(echo.size());
+	update(echo.getRawData());
+}
+
+namespace detail
+{
+	struct _PipelineAccess;
+
+	typedef LidarEchoRef _LidarEchoProxy;
+
+	///operator-> des itérateurs d'échos : garde l'écho dans l'objet retourné plutôt que sur le tas
+	template<typename Reference>
+	struct _LidarEchoArrowProxy
+	{
+		explicit _LidarEchoArrowProxy(const Reference& echo): m_echo(echo) {}
+		Reference* operator->() { return &m_echo; }
+
 		private:
-			char *m_dataPtr;
-			std::size_t m_increment;
-			shared_ptr<AttributeMapType> m_attributeMap; //infos sur les attributs
+			Reference m_echo;
 	};
 
 	struct _LidarIteratorEchoBase : public std::iterator<std::random_access_iterator_tag, LidarEcho>
@@ -150,6 +209,9 @@ namespace detail
 
 
 		protected:
+			///the pipelines read the echoes through the pointer, without copy (LidarPipeline.h)
+			friend struct _PipelineAccess;
+
 			void incremente()
 			{
 				m_dataPtr += m_increment;
@@ -157,7 +219,7 @@ namespace detail
 
 			void incremente(const difference_type i)
 			{
-				m_dataPtr += m_increment * i;
+				m_dataPtr += static_cast<difference_type>(m_increment) * i;
 			}
 
 			void decremente()
@@ -181,8 +243,8 @@ struct LidarIteratorEcho : public detail::_LidarIteratorEchoBase
 
 		typedef LidarIteratorEcho Self;
 
-	    typedef detail::_LidarEchoProxy  reference;
-	    typedef shared_ptr<detail::_LidarEchoProxy> pointer;
+	    typedef LidarEchoRef  reference;
+	    typedef detail::_LidarEchoArrowProxy<LidarEchoRef> pointer;
 
 	    LidarIteratorEcho(){}
 
@@ -198,7 +260,7 @@ struct LidarIteratorEcho : public detail::_LidarIteratorEchoBase
 
 		pointer operator->() const
 		{
-			return pointer(new reference(**this));
+			return pointer(**this);
 		}
 
 		const Self operator--(int)
@@ -258,7 +320,7 @@ struct LidarIteratorEcho : public detail::_LidarIteratorEchoBase
 		inline friend const difference_type operator- (const Self &lhs, const Self &rhs)
 		{
 			assert(lhs.m_increment == rhs.m_increment);
-			return static_cast<difference_type>( (lhs.m_dataPtr - rhs.m_dataPtr) / lhs.m_increment);
+			return (lhs.m_dataPtr - rhs.m_dataPtr) / static_cast<difference_type>(lhs.m_increment);
 		}
 
 		inline friend const Self operator+(const difference_type n, const Self& rhs)
@@ -286,6 +348,12 @@ struct LidarIteratorEcho : public detail::_LidarIteratorEchoBase
 			return *reinterpret_cast<TAttributeType*>(m_dataPtr + decalage);
 		}
 
+		template<typename TAttributeType>
+		TAttributeType& value(const AttributeHandle<TAttributeType> &handle) const
+		{
+			return handle(m_dataPtr);
+		}
+
 		friend struct LidarConstIteratorEcho;
 };
 
@@ -300,7 +368,7 @@ struct LidarConstIteratorEcho : public detail::_LidarIteratorEchoBase
 		typedef LidarConstIteratorEcho Self;
 
 	    typedef const LidarEcho  reference;
-	    typedef shared_ptr<const LidarEcho> pointer;
+	    typedef detail::_LidarEchoArrowProxy<const LidarEcho> pointer;
 
 	    LidarConstIteratorEcho(){}
 
@@ -318,7 +386,7 @@ struct LidarConstIteratorEcho : public detail::_LidarIteratorEchoBase
 
 		pointer operator->() const
 		{
-			return pointer(new reference(**this));
+			return pointer(**this);
 		}
 
 		const Self operator--(int)
@@ -378,7 +446,7 @@ struct LidarConstIteratorEcho : public detail::_LidarIteratorEchoBase
 		inline friend const difference_type operator- (const Self &lhs, const Self &rhs)
 		{
 			assert(lhs.m_increment == rhs.m_increment);
-			return static_cast<difference_type>( (lhs.m_dataPtr - rhs.m_dataPtr) / lhs.m_increment);
+			return (lhs.m_dataPtr - rhs.m_dataPtr) / static_cast<difference_type>(lhs.m_increment);
 		}
 
 		inline friend const Self operator+(const difference_type n, const Self& rhs)
@@ -398,6 +466,12 @@ struct LidarConstIteratorEcho : public detail::_LidarIteratorEchoBase
 			return *reinterpret_cast<TAttributeType*>(m_dataPtr + decalage);
 		}
 
+		template<typename TAttributeType>
+		const TAttributeType value(const AttributeHandle<TAttributeType> &handle) const
+		{
+			return handle(const_cast<const char*>(m_dataPtr));
+		}
+
 
 
 };
@@ -407,7 +481,4 @@ struct LidarConstIteratorEcho : public detail::_LidarIteratorEchoBase
 } //namespace Lidar
 
 
-void swap(Lidar::detail::_LidarEchoProxy p1, Lidar::detail::_LidarEchoProxy p2);
-
-
 #endif /* LIDARITERATORECHO_H_ */
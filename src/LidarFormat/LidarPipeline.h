@@ -0,0 +1,433 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef LIDARPIPELINE_H_
+#define LIDARPIPELINE_H_
+
+#include <vector>
+#include <cstring>
+#include <utility>
+#include <stdexcept>
+#include <functional>
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include "LidarFormat/LidarDataContainer.h"
+
+
+namespace Lidar
+{
+
+/**
+* Echoes of a container given by their indices, in the order of the indices (pipeline source over the echoes of an index view
+* or of a selection view) : Indices is std::vector<EchoIndexType>, LidarSelection, or any sequence of indices with begin()/end().
+* The indices must be less than container.size() ; the container and the indices must outlive the pipelines.
+*/
+template<typename Indices>
+class LidarEchoSubset
+{
+	public:
+		LidarEchoSubset(const LidarDataContainer& container, const Indices& indices): m_container(&container), m_indices(&indices) {}
+
+		const LidarDataContainer& container() const { return *m_container; }
+		const Indices& indices() const { return *m_indices; }
+
+		unsigned int pointSize() const { return m_container->pointSize(); }
+		const AttributeMapType& getAttributeMap() const { return m_container->getAttributeMap(); }
+
+	private:
+		const LidarDataContainer* m_container;
+		const Indices* m_indices;
+};
+
+namespace detail
+{
+
+//attribute map shared with the iterators of the container : not public, it must never be modified in place
+//  bytes of the echo an iterator points to : *it would copy them into a LidarEcho
+struct _PipelineAccess
+{
+	static const shared_ptr<AttributeMapType>& attributeMap(const LidarDataContainer& container) { return container.attributeMap_; }
+	static const char* rawData(const _LidarIteratorEchoBase& it) { return it.m_dataPtr; }
+};
+
+//container read by a pipeline over a container or a slice
+inline const LidarDataContainer& _pipelineContainer(const LidarDataContainer& container) { return container; }
+template<typename Slice> const LidarDataContainer& _pipelineContainer(const Slice& slice) { return *slice.container(); }
+
+//stages of a LidarPipeline : operator()(it) returns false when the echo is dropped
+//  modifies : the echoes are modified, they have to be copied out of the source first
+
+struct _PipelineSource
+{
+	static const bool modifies = false;
+
+	bool operator()(const LidarIteratorEcho&) { return true; }
+};
+
+template<typename Previous, typename Predicate>
+struct _PipelineFilter
+{
+	static const bool modifies = Previous::modifies;
+
+	_PipelineFilter(const Previous& previous, const Predicate& predicate): m_previous(previous), m_predicate(predicate) {}
+
+	bool operator()(const LidarIteratorEcho& it)
+	{
+		return m_previous(it) && m_predicate(LidarConstIteratorEcho(it));
+	}
+
+	Previous m_previous;
+	Predicate m_predicate;
+};
+
+template<typename Previous, typename Functor>
+struct _PipelineTransform
+{
+	static const bool modifies = true;
+
+	_PipelineTransform(const Previous& previous, const Functor& functor): m_previous(previous), m_functor(functor) {}
+
+	bool operator()(const LidarIteratorEcho& it)
+	{
+		if(!m_previous(it))
+			return false;
+		m_functor(it);
+		return true;
+	}
+
+	Previous m_previous;
+	Functor m_functor;
+};
+
+template<typename T, typename Functor>
+struct _AttributeTransform
+{
+	_AttributeTransform(const AttributeHandle<T>& handle, const Functor& functor): m_handle(handle), m_functor(functor) {}
+
+	void operator()(const LidarIteratorEcho& it)
+	{
+		T& value = it.value(m_handle);
+		value = m_functor(value);
+	}
+
+	AttributeHandle<T> m_handle;
+	Functor m_functor;
+};
+
+//sinks
+struct _PipelineCount
+{
+	void operator()(const LidarConstIteratorEcho&) {}
+};
+
+template<typename T, typename Reduce>
+struct _PipelineReduce
+{
+	_PipelineReduce(const AttributeHandle<T>& handle, const T& init, const Reduce& reduce): m_handle(handle), m_result(init), m_reduce(reduce) {}
+
+	void operator()(const LidarConstIteratorEcho& it)
+	{
+		m_result = m_reduce(m_result, it.value(m_handle));
+	}
+
+	AttributeHandle<T> m_handle;
+	T m_result;
+	Reduce m_reduce;
+};
+
+//bytes [destination, destination+size) of the result echo, copied from source
+struct _PipelineCopySegment
+{
+	unsigned int source;
+	unsigned int destination;
+	unsigned int size;
+};
+
+struct _PipelineCopy
+{
+	_PipelineCopy(LidarDataContainer& result, const std::vector<_PipelineCopySegment>& segments):
+		m_result(result), m_segments(segments), m_echo(result.pointSize()) {}
+
+	void operator()(const LidarConstIteratorEcho& it)
+	{
+		const char* source = _PipelineAccess::rawData(it);
+		for(std::vector<_PipelineCopySegment>::const_iterator itSegment = m_segments.begin(); itSegment != m_segments.end(); ++itSegment)
+			std::memcpy(&m_echo[itSegment->destination], source + itSegment->source, itSegment->size);
+		m_result.push_back(&m_echo[0]);
+	}
+
+	LidarDataContainer& m_result;
+	const std::vector<_PipelineCopySegment>& m_segments;
+	std::vector<char> m_echo;
+};
+
+//runs the stages on the echoes data + index*pointSize, for the indices of [first, last)
+template<typename IndexIterator, typename Stages, typename Sink>
+std::size_t _runPipeline(const char* data, const unsigned int pointSize, const shared_ptr<AttributeMapType>& attributeMap, IndexIterator first, const IndexIterator last, Stages stages, Sink& sink)
+{
+	std::size_t nbEchos = 0;
+
+	if(Stages::modifies)
+	{
+		std::vector<char> work(pointSize);
+		const LidarIteratorEcho itWork(&work[0], pointSize, attributeMap);
+		for( ; first != last; ++first)
+		{
+			std::memcpy(&work[0], data + static_cast<std::size_t>(*first)*pointSize, pointSize);
+			if(stages(itWork))
+			{
+				sink(LidarConstIteratorEcho(itWork));
+				++nbEchos;
+			}
+		}
+	}
+	else
+	{
+		//read in place : without transform, nothing writes through the iterator
+		LidarIteratorEcho it(const_cast<char*>(data), pointSize, attributeMap);
+		std::size_t position = 0;
+		for( ; first != last; ++first)
+		{
+			const std::size_t index = *first;
+			it += static_cast<std::ptrdiff_t>(index) - static_cast<std::ptrdiff_t>(position);
+			position = index;
+			if(stages(it))
+			{
+				sink(LidarConstIteratorEcho(it));
+				++nbEchos;
+			}
+		}
+	}
+
+	return nbEchos;
+}
+
+//container or slice : all its echoes
+template<typename Source, typename Stages, typename Sink>
+std::size_t _runPipeline(const Source& source, const Stages& stages, Sink& sink)
+{
+	return _runPipeline(source.rawData(), source.pointSize(), _PipelineAccess::attributeMap(_pipelineContainer(source)), boost::counting_iterator<std::size_t>(0), boost::counting_iterator<std::size_t>(source.size()), stages, sink);
+}
+
+template<typename Indices, typename Stages, typename Sink>
+std::size_t _runPipeline(const LidarEchoSubset<Indices>& source, const Stages& stages, Sink& sink)
+{
+	return _runPipeline(source.container().rawData(), source.pointSize(), _PipelineAccess::attributeMap(source.container()), source.indices().begin(), source.indices().end(), stages, sink);
+}
+
+//how a pipeline keeps its source : containers and slices by address, subsets (two addresses already) by value
+template<typename Source>
+struct _PipelineSourceRef
+{
+	explicit _PipelineSourceRef(const Source& source): m_source(&source) {}
+	const Source& get() const { return *m_source; }
+
+	const Source* m_source;
+};
+
+template<typename Indices>
+struct _PipelineSourceRef<LidarEchoSubset<Indices> >
+{
+	explicit _PipelineSourceRef(const LidarEchoSubset<Indices>& source): m_source(source) {}
+	const LidarEchoSubset<Indices>& get() const { return m_source; }
+
+	LidarEchoSubset<Indices> m_source;
+};
+
+//bytes the pipeline may read
+template<typename Source>
+std::pair<const char*, const char*> _pipelineSourceBytes(const Source& source)
+{
+	return std::make_pair(source.rawData(), source.rawData() + source.size()*source.pointSize());
+}
+
+template<typename Indices>
+std::pair<const char*, const char*> _pipelineSourceBytes(const LidarEchoSubset<Indices>& source)
+{
+	return _pipelineSourceBytes(source.container());
+}
+
+} //namespace detail
+
+
+/**
+* @brief Lazy chain of filters and transforms over the echoes of a container, of a LidarDataSlice,
+* or of a LidarEchoSubset (the echoes of an index or selection view).
+*
+* filter() and transform() only build the chain (one type per stage, no virtual call) ; nothing is read until a sink
+* (forEach, count, reduce, copyTo) pulls the echoes. Each echo then goes through the whole chain at once :
+* one pass over the data whatever the number of stages, and no intermediate container.
+*
+* The source is never modified : when the chain has transforms, each echo is first copied to a working echo.
+* The source must outlive the pipeline. Predicates and functors follow LidarDataContainer::eraseIf :
+* filter(pred) with pred(const LidarConstIteratorEcho&), filter(handle, pred) with pred(T value) ;
+* transform(f) with f(const LidarIteratorEcho&) modifying the echo, transform(handle, f) with value = f(value).
+*
+* Example : makePipeline(container).transform(hX, Centered(x0)).filter(hClass, IsGround()).filter(InBox(box)).copyTo(result)
+*/
+template<typename Source, typename Stages = detail::_PipelineSource>
+class LidarPipeline
+{
+	public:
+		explicit LidarPipeline(const Source& source, const Stages& stages = Stages()): m_source(source), m_stages(stages) {}
+
+		///Stages
+		template<typename Predicate> LidarPipeline<Source, detail::_PipelineFilter<Stages, Predicate> > filter(const Predicate& predicate) const
+		{
+			return LidarPipeline<Source, detail::_PipelineFilter<Stages, Predicate> >(m_source.get(), detail::_PipelineFilter<Stages, Predicate>(m_stages, predicate));
+		}
+		template<typename T, typename Predicate> LidarPipeline<Source, detail::_PipelineFilter<Stages, detail::_LidarAttributePredicate<T, Predicate> > > filter(const AttributeHandle<T>& handle, const Predicate& predicate) const
+		{
+			return filter(detail::_LidarAttributePredicate<T, Predicate>(handle, predicate));
+		}
+		template<typename Functor> LidarPipeline<Source, detail::_PipelineTransform<Stages, Functor> > transform(const Functor& functor) const
+		{
+			return LidarPipeline<Source, detail::_PipelineTransform<Stages, Functor> >(m_source.get(), detail::_PipelineTransform<Stages, Functor>(m_stages, functor));
+		}
+		template<typename T, typename Functor> LidarPipeline<Source, detail::_PipelineTransform<Stages, detail::_AttributeTransform<T, Functor> > > transform(const AttributeHandle<T>& handle, const Functor& functor) const
+		{
+			return transform(detail::_AttributeTransform<T, Functor>(handle, functor));
+		}
+
+		///Sinks : they run the pipeline and return the number of echoes that went through it
+
+		///sink(const LidarConstIteratorEcho&) for each echo (a writer...)
+		template<typename Sink> std::size_t forEach(Sink sink) const
+		{
+			return run(sink);
+		}
+		std::size_t count() const
+		{
+			detail::_PipelineCount sink;
+			return run(sink);
+		}
+		///reduce(... reduce(init, value of the first echo) ..., value of the last echo)
+		template<typename T, typename Reduce> T reduce(const AttributeHandle<T>& handle, const T& init, Reduce reduce) const
+		{
+			detail::_PipelineReduce<T, Reduce> sink(handle, init, reduce);
+			run(sink);
+			return sink.m_result;
+		}
+		///Appends the echoes to result : without attributes, result gets the ones of the source ;
+		///  otherwise its attributes are taken by name from the source (they must be there, with the same type)
+		///  result may be the container read by the pipeline : the echoes are then appended once the pipeline has run
+		std::size_t copyTo(LidarDataContainer& result) const
+		{
+			if(result.getAttributeMap().empty())
+			{
+				LidarDataContainer::AttributeListType attributes;
+				for(AttributeMapType::const_iterator it = m_source.get().getAttributeMap().begin(); it != m_source.get().getAttributeMap().end(); ++it)
+					attributes.push_back(LidarDataContainer::AttributeListType::value_type(it->first, it->second.type));
+				result.addAttributes(attributes);
+			}
+
+			//consecutive attributes merged, a single memcpy when the layouts are the same
+			std::vector<detail::_PipelineCopySegment> segments;
+			for(AttributeMapType::const_iterator it = result.getAttributeMap().begin(); it != result.getAttributeMap().end(); ++it)
+			{
+				const AttributeMapType::const_iterator itSource = m_source.get().getAttributeMap().find(it->first);
+				if(itSource == m_source.get().getAttributeMap().end() || itSource->second.type != it->second.type)
+					throw std::logic_error("Error in LidarPipeline::copyTo : attribute " + it->first + " is not in the source, or has another type !\n");
+
+				AttributeMapType::const_iterator itNext = it;
+				const unsigned int size = (++itNext == result.getAttributeMap().end() ? result.pointSize() : itNext->second.decalage) - it->second.decalage;
+				detail::_PipelineCopySegment* last = segments.empty() ? 0 : &segments.back();
+				if(last && last->destination + last->size == it->second.decalage && last->source + last->size == itSource->second.decalage)
+					last->size += size;
+				else
+				{
+					detail::_PipelineCopySegment segment = {itSource->second.decalage, it->second.decalage, size};
+					segments.push_back(segment);
+				}
+			}
+
+			//pushing into the buffer being read could reallocate it under the pipeline
+			const std::pair<const char*, const char*> sourceBytes = detail::_pipelineSourceBytes(m_source.get());
+			const char* resultBegin = result.rawData();
+			const char* resultEnd = resultBegin + result.size()*result.pointSize();
+			if(sourceBytes.first != sourceBytes.second && std::less<const char*>()(sourceBytes.first, resultEnd) && !std::less<const char*>()(sourceBytes.first, resultBegin))
+			{
+				LidarDataContainer collected;
+				LidarDataContainer::AttributeListType attributes;
+				for(AttributeMapType::const_iterator it = result.getAttributeMap().begin(); it != result.getAttributeMap().end(); ++it)
+					attributes.push_back(LidarDataContainer::AttributeListType::value_type(it->first, it->second.type));
+				collected.addAttributes(attributes);
+
+				detail::_PipelineCopy sink(collected, segments);
+				const std::size_t nbEchos = run(sink);
+				result.append(collected);
+				return nbEchos;
+			}
+
+			detail::_PipelineCopy sink(result, segments);
+			return run(sink);
+		}
+
+	private:
+		template<typename Sink> std::size_t run(Sink& sink) const
+		{
+			return detail::_runPipeline(m_source.get(), m_stages, sink);
+		}
+
+		detail::_PipelineSourceRef<Source> m_source;
+		Stages m_stages;
+};
+
+///makePipeline(container) : LidarPipeline<LidarDataContainer>(container)
+template<typename Source>
+LidarPipeline<Source> makePipeline(const Source& source)
+{
+	return LidarPipeline<Source>(source);
+}
+
+///makePipeline(container, indices) : pipeline over the echoes container[i] for i in indices (std::vector<EchoIndexType>, LidarSelection...)
+template<typename Indices>
+LidarPipeline<LidarEchoSubset<Indices> > makePipeline(const LidarDataContainer& container, const Indices& indices)
+{
+	return LidarPipeline<LidarEchoSubset<Indices> >(LidarEchoSubset<Indices>(container, indices));
+}
+
+} //namespace Lidar
+
+#endif /* LIDARPIPELINE_H_ */
@@ -0,0 +1,273 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#include <stdexcept>
+#include <algorithm>
+
+#include "LidarFormat/LidarDataContainer.h"
+#include "apply.h"
+
+#include "LidarSegmentedDataContainer.h"
+
+
+namespace Lidar
+{
+
+const std::size_t LidarSegmentedDataContainer::defaultNbEchosPerBlock;
+
+namespace
+{
+
+template<EnumLidarDataType T>
+struct AttributeSizeFunctor
+{
+	unsigned int operator()()
+	{
+		return sizeof( typename LidarEnumTypeTraits<T>::type );
+	}
+};
+
+} //namespace
+
+
+LidarSegmentedDataContainer::LidarSegmentedDataContainer(const std::size_t nbEchosPerBlock):
+	attributeMap_(new AttributeMapType), allocator_(LidarDataAllocator::defaultAllocator()),
+	nbEchosPerBlock_(std::max<std::size_t>(1, nbEchosPerBlock)), size_(0), pointSize_(0)
+{
+}
+
+LidarSegmentedDataContainer::LidarSegmentedDataContainer(const LidarSegmentedDataContainer& rhs):
+	attributeMap_(rhs.attributeMap_), allocator_(rhs.allocator_),
+	nbEchosPerBlock_(rhs.nbEchosPerBlock_), size_(0), pointSize_(0)
+{
+	copy(rhs);
+}
+
+LidarSegmentedDataContainer& LidarSegmentedDataContainer::operator=(const LidarSegmentedDataContainer& rhs)
+{
+	if(this!=&rhs)
+		copy(rhs);
+
+	return *this;
+}
+
+void LidarSegmentedDataContainer::copy(const LidarSegmentedDataContainer& rhs)
+{
+	attributeMap_ = rhs.attributeMap_;
+	allocator_ = rhs.allocator_;
+	nbEchosPerBlock_ = rhs.nbEchosPerBlock_;
+	pointSize_ = rhs.pointSize_;
+
+	clear();
+	for(std::size_t i = 0; i < rhs.getNbBlocks(); ++i)
+		append(rhs.getBlock(i), rhs.getBlockSize(i));
+}
+
+bool LidarSegmentedDataContainer::addAttribute(const std::string& attributeName, const EnumLidarDataType type)
+{
+	if(!empty())
+		throw std::logic_error("Error in LidarSegmentedDataContainer::addAttribute : the container must be empty !\n");
+
+	//si l'attribut existe déjà, on sort et retourne false
+	if(attributeMap_->find(attributeName)!=attributeMap_->end())
+		return false;
+
+	AttributesInfo infos;
+	infos.type = type;
+	infos.decalage = pointSize_;
+	//the description is shared by the copies of the container: copy on write
+	attributeMap_.reset(new AttributeMapType(*attributeMap_));
+	attributeMap_->push_back(AttributeMapType::value_type(attributeName, infos));
+
+	pointSize_ += apply<AttributeSizeFunctor, unsigned int>(type);
+
+	//the blocks allocated in advance do not have the right size anymore
+	blocks_.clear();
+
+	return true;
+}
+
+void LidarSegmentedDataContainer::setAttributes(const AttributeMapType& attributeMap)
+{
+	if(!empty())
+		throw std::logic_error("Error in LidarSegmentedDataContainer::setAttributes : the container must be empty !\n");
+
+	attributeMap_.reset(new AttributeMapType(attributeMap));
+
+	pointSize_ = 0;
+	for(AttributeMapType::const_iterator it = attributeMap_->begin(); it != attributeMap_->end(); ++it)
+		pointSize_ = std::max(pointSize_, it->second.decalage + apply<AttributeSizeFunctor, unsigned int>(it->second.type));
+
+	blocks_.clear();
+}
+
+bool LidarSegmentedDataContainer::checkAttributeIsPresent(const std::string& attributeName) const
+{
+	return attributeMap_->find(attributeName) != attributeMap_->end();
+}
+
+EnumLidarDataType LidarSegmentedDataContainer::getAttributeType(const std::string &attributeName) const
+{
+	return attributeMap_->find(attributeName)->second.type;
+}
+
+LidarDataBuffer& LidarSegmentedDataContainer::nextBlock()
+{
+	const std::size_t i = size_ / nbEchosPerBlock_;
+
+	if(i == blocks_.size())
+	{
+		//reserved once: the echoes of a block never move
+		shared_ptr<LidarDataBuffer> block(new LidarDataBuffer);
+		block->setAllocator(allocator_);
+		block->reserve(nbEchosPerBlock_*pointSize_);
+		blocks_.push_back(block);
+	}
+
+	return *blocks_[i];
+}
+
+void LidarSegmentedDataContainer::reserve(const std::size_t nbEchos)
+{
+	const std::size_t saveSize = size_;
+
+	//allocates the missing blocks by walking through their first echoes
+	for(size_ = blocks_.size()*nbEchosPerBlock_; size_ < nbEchos; size_ += nbEchosPerBlock_)
+		nextBlock();
+
+	size_ = saveSize;
+}
+
+void LidarSegmentedDataContainer::resize(const std::size_t nbEchos)
+{
+	while(size_ < nbEchos)
+	{
+		LidarDataBuffer& block = nextBlock();
+		const std::size_t nbNewEchos = std::min(nbEchos - size_, nbEchosPerBlock_ - size_ % nbEchosPerBlock_);
+		block.resize(block.size() + nbNewEchos*pointSize_);
+		size_ += nbNewEchos;
+	}
+
+	if(nbEchos < size_)
+	{
+		//the blocks after the new last one are released
+		const std::size_t nbBlocks = (nbEchos + nbEchosPerBlock_ - 1) / nbEchosPerBlock_;
+		blocks_.resize(nbBlocks);
+		if(nbBlocks > 0)
+			blocks_.back()->resize((nbEchos - (nbBlocks-1)*nbEchosPerBlock_)*pointSize_);
+		size_ = nbEchos;
+	}
+}
+
+void LidarSegmentedDataContainer::clear()
+{
+	blocks_.clear();
+	size_ = 0;
+}
+
+void LidarSegmentedDataContainer::push_back(const LidarEcho& echo)
+{
+	assert(echo.size() == pointSize());
+	push_back(echo.getRawData());
+}
+
+void LidarSegmentedDataContainer::push_back(const char* echo)
+{
+	append(echo, 1);
+}
+
+void LidarSegmentedDataContainer::append(const char* data, std::size_t nbEchos)
+{
+	while(nbEchos > 0)
+	{
+		LidarDataBuffer& block = nextBlock();
+		const std::size_t nbCopiedEchos = std::min(nbEchos, nbEchosPerBlock_ - size_ % nbEchosPerBlock_);
+		block.append(data, data + nbCopiedEchos*pointSize_);
+
+		data += nbCopiedEchos*pointSize_;
+		nbEchos -= nbCopiedEchos;
+		size_ += nbCopiedEchos;
+	}
+}
+
+void LidarSegmentedDataContainer::append(const LidarDataContainer& rhs)
+{
+	assert(rhs.pointSize() == pointSize());
+	append(rhs.rawData(), rhs.size());
+}
+
+void LidarSegmentedDataContainer::append(const LidarSegmentedDataContainer& rhs)
+{
+	assert(rhs.pointSize() == pointSize());
+
+	//the size of rhs is read before appending: rhs may be *this
+	const std::size_t nbEchos = rhs.size();
+	for(std::size_t first = 0; first < nbEchos; first += rhs.nbEchosPerBlock_)
+		append(rhs.getBlock(first / rhs.nbEchosPerBlock_), std::min(rhs.nbEchosPerBlock_, nbEchos - first));
+}
+
+void LidarSegmentedDataContainer::copyTo(LidarDataContainer& lidarContainer) const
+{
+	if(lidarContainer.getAttributeMap().empty())
+	{
+		for(AttributeMapType::const_iterator it = attributeMap_->begin(); it != attributeMap_->end(); ++it)
+			lidarContainer.addAttribute(it->first, it->second.type);
+	}
+	else
+	{
+		//the blocks are copied byte for byte: same names, types and offsets, in the same order
+		const AttributeMapType& attributeMap = lidarContainer.getAttributeMap();
+		bool sameLayout = lidarContainer.pointSize() == pointSize_ && attributeMap.size() == attributeMap_->size();
+		for(AttributeMapType::const_iterator it = attributeMap_->begin(), itTarget = attributeMap.begin(); sameLayout && it != attributeMap_->end(); ++it, ++itTarget)
+			sameLayout = it->first == itTarget->first && it->second.type == itTarget->second.type && it->second.decalage == itTarget->second.decalage;
+		if(!sameLayout)
+			throw std::logic_error("Error in LidarSegmentedDataContainer::copyTo : the attributes of the containers are different !\n");
+	}
+
+	lidarContainer.resizeUninitialized(size_);
+
+	for(std::size_t i = 0; i < getNbBlocks(); ++i)
+		std::copy(getBlock(i), getBlock(i) + getBlockSize(i)*pointSize_, lidarContainer.rawData(i*nbEchosPerBlock_));
+}
+
+} //namespace Lidar
@@ -0,0 +1,171 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef LIDARSEGMENTEDDATACONTAINER_H_
+#define LIDARSEGMENTEDDATACONTAINER_H_
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "LidarFormat/AttributesInfo.h"
+#include "LidarFormat/LidarDataBuffer.h"
+#include "LidarFormat/LidarSegmentedIteratorEcho.h"
+#include "LidarFormat/LidarDataFormatTypes.h"
+
+
+namespace Lidar
+{
+
+using boost::shared_ptr;
+
+class LidarDataContainer;
+
+/**
+* @brief Echoes stored in blocks of a fixed number of echoes.
+*
+* Same records as a LidarDataContainer, but the echoes are not contiguous: they are stored in
+* blocks of getNbEchosPerBlock() echoes. Growing the container allocates one more block and never
+* moves the echoes already stored, so it never needs twice the memory. Iterators cross the block
+* boundaries; each block can also be processed on its own (getBlock), e.g. by a thread.
+*
+* Use copyTo() to get a contiguous LidarDataContainer (to save the data for instance).
+*
+*/
+
+class LidarSegmentedDataContainer
+{
+	public:
+		typedef LidarEcho									value_type;
+		typedef std::size_t									size_type;
+		typedef LidarSegmentedIteratorEcho					iterator;
+		typedef LidarSegmentedConstIteratorEcho				const_iterator;
+		typedef iterator::reference							reference;
+		typedef const_iterator::reference					const_reference;
+
+		///1M echoes: a few tens of MB per block
+		static const std::size_t defaultNbEchosPerBlock = 1024*1024;
+
+		explicit LidarSegmentedDataContainer(const std::size_t nbEchosPerBlock = defaultNbEchosPerBlock);
+		LidarSegmentedDataContainer(const LidarSegmentedDataContainer& rhs);
+		LidarSegmentedDataContainer& operator=(const LidarSegmentedDataContainer& rhs);
+
+
+		///The attributes can only be set on an empty container
+		bool addAttribute(const std::string& attributeName, const EnumLidarDataType type);
+		///Same attributes (and records) as another container
+		void setAttributes(const AttributeMapType& attributeMap);
+
+		bool checkAttributeIsPresent(const std::string& attributeName) const;
+		EnumLidarDataType getAttributeType(const std::string &attributeName) const;
+		const AttributeMapType& getAttributeMap() const { return *attributeMap_; }
+		unsigned int getDecalage(const std::string &attributeName) const { return attributeMap_->find(attributeName)->second.decalage; }
+		template<typename T> AttributeHandle<T> handle(const std::string &attributeName) const { return makeAttributeHandle<T>(*attributeMap_, attributeName); }
+		unsigned int pointSize() const { return pointSize_; }
+
+
+		///Interface semblable au vector :
+		bool empty() const { return size_==0; }
+		std::size_t size() const { return size_; }
+		std::size_t capacity() const { return blocks_.size()*nbEchosPerBlock_; }
+		///Allocates the blocks in advance
+		void reserve(const std::size_t nbEchos);
+		///New echoes are set to 0
+		void resize(const std::size_t nbEchos);
+		///Releases the blocks
+		void clear();
+
+		void push_back(const LidarEcho& echo);
+		void push_back(const char* echo);
+		///rhs must have the same attributes
+		void append(const LidarDataContainer& rhs);
+		void append(const LidarSegmentedDataContainer& rhs);
+
+		reference operator[](const std::size_t index) { return *(begin() + index); }
+		const_reference operator[](const std::size_t index) const { return *(begin() + index); }
+
+		iterator begin() { return iterator(&blocks_, 0, nbEchosPerBlock_, pointSize_, attributeMap_); }
+		iterator end() { return iterator(&blocks_, size_, nbEchosPerBlock_, pointSize_, attributeMap_); }
+		const_iterator begin() const { return const_iterator(&blocks_, 0, nbEchosPerBlock_, pointSize_, attributeMap_); }
+		const_iterator end() const { return const_iterator(&blocks_, size_, nbEchosPerBlock_, pointSize_, attributeMap_); }
+
+		char* rawData(const std::size_t index) { return blocks_[index / nbEchosPerBlock_]->data() + (index % nbEchosPerBlock_)*pointSize_; }
+		const char* rawData(const std::size_t index) const { return blocks_[index / nbEchosPerBlock_]->data() + (index % nbEchosPerBlock_)*pointSize_; }
+
+
+		///Blocks : getBlockSize(i) echoes start at getBlock(i) (all blocks are full but the last one)
+		std::size_t getNbEchosPerBlock() const { return nbEchosPerBlock_; }
+		std::size_t getNbBlocks() const { return (size_ + nbEchosPerBlock_ - 1) / nbEchosPerBlock_; }
+		char* getBlock(const std::size_t i) { return blocks_[i]->data(); }
+		const char* getBlock(const std::size_t i) const { return blocks_[i]->data(); }
+		std::size_t getBlockSize(const std::size_t i) const { return blocks_[i]->size() / pointSize_; }
+
+		///Allocation policy of the new blocks
+		void setAllocator(const shared_ptr<LidarDataAllocator>& allocator) { allocator_ = allocator; }
+
+		///Contiguous copy of the echoes: the attributes of an empty lidarContainer are set, otherwise they must match
+		void copyTo(LidarDataContainer& lidarContainer) const;
+
+	private:
+		void copy(const LidarSegmentedDataContainer& rhs);
+
+		///Appends nbEchos records stored contiguously from data, filling the last block first
+		void append(const char* data, std::size_t nbEchos);
+
+		///Block where the next echo goes, allocated if needed
+		LidarDataBuffer& nextBlock();
+
+
+		LidarDataBlockListType blocks_;
+		shared_ptr<AttributeMapType> attributeMap_;
+		shared_ptr<LidarDataAllocator> allocator_;
+
+		std::size_t nbEchosPerBlock_;
+		std::size_t size_;
+		unsigned int pointSize_;
+};
+
+} //namespace Lidar
+
+#endif /* LIDARSEGMENTEDDATACONTAINER_H_ */
@@ -0,0 +1,210 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef LIDARSEGMENTEDITERATORECHO_H_
+#define LIDARSEGMENTEDITERATORECHO_H_
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "LidarFormat/LidarDataBuffer.h"
+#include "LidarFormat/LidarIteratorEcho.h"
+
+
+namespace Lidar
+{
+
+using boost::shared_ptr;
+
+///Blocks of a LidarSegmentedDataContainer
+typedef std::vector<shared_ptr<LidarDataBuffer> > LidarDataBlockListType;
+
+namespace detail
+{
+	///Position of an echo in a LidarSegmentedDataContainer: the blocks are found from the index of the echo
+	template<typename Derived, typename Reference>
+	class _LidarSegmentedIteratorEchoBase : public boost::iterator_facade<Derived, LidarEcho, boost::random_access_traversal_tag, Reference>
+	{
+		public:
+			_LidarSegmentedIteratorEchoBase():
+				m_blocks(0), m_index(0), m_nbEchosPerBlock(1), m_pointSize(0), m_attributeMap(new AttributeMapType)
+			{
+			}
+
+			_LidarSegmentedIteratorEchoBase(const LidarDataBlockListType* blocks, const std::size_t index, const std::size_t nbEchosPerBlock, const unsigned int pointSize, const shared_ptr<AttributeMapType>& attributeMap):
+				m_blocks(blocks), m_index(index), m_nbEchosPerBlock(nbEchosPerBlock), m_pointSize(pointSize), m_attributeMap(attributeMap)
+			{
+			}
+
+			std::size_t index() const { return m_index; }
+
+		protected:
+			char* rawEcho() const
+			{
+				return (*m_blocks)[m_index / m_nbEchosPerBlock]->data() + (m_index % m_nbEchosPerBlock)*m_pointSize;
+			}
+
+			unsigned int getDecalage(const std::string &attributeName) const
+			{
+				return m_attributeMap->find(attributeName)->second.decalage;
+			}
+
+			const LidarDataBlockListType* m_blocks;
+			std::size_t m_index;
+			std::size_t m_nbEchosPerBlock;
+			unsigned int m_pointSize;
+			shared_ptr<AttributeMapType> m_attributeMap;
+
+		private:
+			friend class boost::iterator_core_access;
+
+			bool equal(const _LidarSegmentedIteratorEchoBase& rhs) const { return m_index == rhs.m_index; }
+			void increment() { ++m_index; }
+			void decrement() { --m_index; }
+			void advance(const std::ptrdiff_t n) { m_index += n; }
+			std::ptrdiff_t distance_to(const _LidarSegmentedIteratorEchoBase& rhs) const
+			{
+				return static_cast<std::ptrdiff_t>(rhs.m_index) - static_cast<std::ptrdiff_t>(m_index);
+			}
+	};
+}
+
+
+/**
+ * \ingroup group_iterators
+ *
+ * Same interface as LidarIteratorEcho, over the blocks of a LidarSegmentedDataContainer
+ */
+class LidarSegmentedIteratorEcho : public detail::_LidarSegmentedIteratorEchoBase<LidarSegmentedIteratorEcho, LidarEchoRef>
+{
+		typedef detail::_LidarSegmentedIteratorEchoBase<LidarSegmentedIteratorEcho, LidarEchoRef> Base;
+
+	public:
+		LidarSegmentedIteratorEcho() {}
+
+		LidarSegmentedIteratorEcho(const LidarDataBlockListType* blocks, const std::size_t index, const std::size_t nbEchosPerBlock, const unsigned int pointSize, const shared_ptr<AttributeMapType>& attributeMap):
+			Base(blocks, index, nbEchosPerBlock, pointSize, attributeMap)
+		{
+		}
+
+		template<typename TAttributeType>
+		TAttributeType& value(const std::string &attributeName) const
+		{
+			return *reinterpret_cast<TAttributeType*>(rawEcho() + getDecalage(attributeName));
+		}
+
+		template<typename TAttributeType>
+		TAttributeType& value(const unsigned int decalage) const
+		{
+			return *reinterpret_cast<TAttributeType*>(rawEcho() + decalage);
+		}
+
+		template<typename TAttributeType>
+		TAttributeType& value(const AttributeHandle<TAttributeType> &handle) const
+		{
+			return handle(rawEcho());
+		}
+
+	private:
+		friend class boost::iterator_core_access;
+		friend class LidarSegmentedConstIteratorEcho;
+
+		LidarEchoRef dereference() const
+		{
+			return LidarEchoRef(rawEcho(), m_pointSize, m_attributeMap);
+		}
+};
+
+
+/**
+ * \ingroup group_iterators
+ */
+class LidarSegmentedConstIteratorEcho : public detail::_LidarSegmentedIteratorEchoBase<LidarSegmentedConstIteratorEcho, const LidarEcho>
+{
+		typedef detail::_LidarSegmentedIteratorEchoBase<LidarSegmentedConstIteratorEcho, const LidarEcho> Base;
+
+	public:
+		LidarSegmentedConstIteratorEcho() {}
+
+		LidarSegmentedConstIteratorEcho(const LidarDataBlockListType* blocks, const std::size_t index, const std::size_t nbEchosPerBlock, const unsigned int pointSize, const shared_ptr<AttributeMapType>& attributeMap):
+			Base(blocks, index, nbEchosPerBlock, pointSize, attributeMap)
+		{
+		}
+
+		LidarSegmentedConstIteratorEcho(const LidarSegmentedIteratorEcho& rhs):
+			Base(rhs.m_blocks, rhs.m_index, rhs.m_nbEchosPerBlock, rhs.m_pointSize, rhs.m_attributeMap)
+		{
+		}
+
+		template<typename TAttributeType>
+		const TAttributeType value(const std::string &attributeName) const
+		{
+			return *reinterpret_cast<const TAttributeType*>(rawEcho() + getDecalage(attributeName));
+		}
+
+		template<typename TAttributeType>
+		const TAttributeType value(const unsigned int decalage) const
+		{
+			return *reinterpret_cast<const TAttributeType*>(rawEcho() + decalage);
+		}
+
+		template<typename TAttributeType>
+		const TAttributeType value(const AttributeHandle<TAttributeType> &handle) const
+		{
+			return handle(rawEcho());
+		}
+
+	private:
+		friend class boost::iterator_core_access;
+
+		const LidarEcho dereference() const
+		{
+			return LidarEcho(m_pointSize, rawEcho(), m_attributeMap);
+		}
+};
+
+} //namespace Lidar
+
+#endif /* LIDARSEGMENTEDITERATORECHO_H_ */
@@ -0,0 +1,145 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#include <stdexcept>
+#include <string>
+
+#include "LidarFormat/LidarSelection.h"
+
+
+namespace Lidar
+{
+
+namespace
+{
+
+unsigned int popCount(LidarSelection::WordType word)
+{
+#if defined(__GNUC__)
+	return static_cast<unsigned int>(__builtin_popcountll(word));
+#else
+	unsigned int n = 0;
+	for(; word; word &= word - 1)
+		++n;
+	return n;
+#endif
+}
+
+} //namespace
+
+const unsigned int LidarSelection::wordSize;
+
+LidarSelection::LidarSelection(const std::size_t size, const bool selected):
+	m_words((size + wordSize - 1)/wordSize, selected ? ~WordType(0) : WordType(0)), m_size(size)
+{
+	//the bits after size() stay at 0
+	if(selected && size%wordSize)
+		m_words.back() = (WordType(1) << (size%wordSize)) - 1;
+}
+
+LidarSelection::LidarSelection(const std::vector<EchoIndexType>& indices, const std::size_t size):
+	m_words((size + wordSize - 1)/wordSize, WordType(0)), m_size(size)
+{
+	for(std::vector<EchoIndexType>::const_iterator it = indices.begin(); it != indices.end(); ++it)
+	{
+		if(*it >= size)
+			throw std::logic_error("Error in LidarSelection : index out of range !\n");
+		set(*it);
+	}
+}
+
+std::size_t LidarSelection::count() const
+{
+	std::size_t n = 0;
+	for(std::vector<WordType>::const_iterator it = m_words.begin(); it != m_words.end(); ++it)
+		n += popCount(*it);
+	return n;
+}
+
+void LidarSelection::checkSize(const LidarSelection& rhs, const char* function) const
+{
+	if(rhs.m_size != m_size)
+		throw std::logic_error(std::string("Error in LidarSelection::") + function + " : selections of different sizes !\n");
+}
+
+LidarSelection& LidarSelection::operator&=(const LidarSelection& rhs)
+{
+	checkSize(rhs, "operator&=");
+	for(std::size_t w = 0; w < m_words.size(); ++w)
+		m_words[w] &= rhs.m_words[w];
+	return *this;
+}
+
+LidarSelection& LidarSelection::operator|=(const LidarSelection& rhs)
+{
+	checkSize(rhs, "operator|=");
+	for(std::size_t w = 0; w < m_words.size(); ++w)
+		m_words[w] |= rhs.m_words[w];
+	return *this;
+}
+
+LidarSelection& LidarSelection::subtract(const LidarSelection& rhs)
+{
+	checkSize(rhs, "subtract");
+	for(std::size_t w = 0; w < m_words.size(); ++w)
+		m_words[w] &= ~rhs.m_words[w];
+	return *this;
+}
+
+LidarSelection& LidarSelection::flip()
+{
+	for(std::size_t w = 0; w < m_words.size(); ++w)
+		m_words[w] = ~m_words[w];
+	if(m_size%wordSize)
+		m_words.back() &= (WordType(1) << (m_size%wordSize)) - 1;
+	return *this;
+}
+
+void LidarSelection::getIndices(std::vector<EchoIndexType>& indices) const
+{
+	indices.clear();
+	indices.reserve(count());
+	indices.insert(indices.end(), begin(), end());
+}
+
+} //namespace Lidar
@@ -0,0 +1,181 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef LIDARSELECTION_H_
+#define LIDARSELECTION_H_
+
+#include <vector>
+#include <cstddef>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "LidarFormat/LidarDataFormatTypes.h"
+
+
+namespace Lidar
+{
+
+namespace detail
+{
+
+//position of the lowest set bit (word != 0)
+inline unsigned int _lowestBit(const uint64 word)
+{
+#if defined(__GNUC__)
+	return static_cast<unsigned int>(__builtin_ctzll(word));
+#else
+	unsigned int n = 0;
+	for(uint64 w = word; !(w & 1u); w >>= 1)
+		++n;
+	return n;
+#endif
+}
+
+} //namespace detail
+
+/**
+* @brief Selection of echoes of a container, stored as a bitmap (one bit per echo).
+*
+* Alternative to a vector of indices for dense selections: 1 bit per echo instead of 4 or 8 bytes
+* per selected echo, and the selected echoes are visited in increasing order (sequential access to the data).
+* Selections of the same size are combined with &, | and ~.
+*
+*/
+class LidarSelection
+{
+	public:
+		typedef uint64 WordType;
+		static const unsigned int wordSize = 64;
+
+		///Iterator on the indices of the selected echoes, in increasing order
+		class const_iterator : public boost::iterator_facade<const_iterator, EchoIndexType, boost::forward_traversal_tag, EchoIndexType>
+		{
+			public:
+				const_iterator(): m_words(0), m_index(0), m_size(0) {}
+				const_iterator(const WordType* words, const std::size_t index, const std::size_t size): m_words(words), m_index(index), m_size(size)
+				{
+					if(m_index < m_size && !(m_words[m_index/wordSize] & (WordType(1) << (m_index%wordSize))))
+						next(m_index);
+				}
+
+			private:
+				friend class boost::iterator_core_access;
+
+				//first selected index from index (or size)
+				void next(std::size_t index)
+				{
+					std::size_t w = index/wordSize;
+					const std::size_t nbWords = (m_size + wordSize - 1)/wordSize;
+					if(w >= nbWords)
+					{
+						m_index = m_size;
+						return;
+					}
+					WordType word = m_words[w] & (~WordType(0) << (index%wordSize));
+					while(!word && ++w < nbWords)
+						word = m_words[w];
+					m_index = word ? w*wordSize + detail::_lowestBit(word) : m_size;
+				}
+
+				void increment() { next(m_index + 1); }
+				bool equal(const const_iterator& other) const { return m_index == other.m_index; }
+				EchoIndexType dereference() const { return static_cast<EchoIndexType>(m_index); }
+
+				const WordType* m_words;
+				std::size_t m_index;
+				std::size_t m_size;
+		};
+		typedef const_iterator iterator;
+
+		LidarSelection(): m_size(0) {}
+		///size echoes, all selected or none
+		explicit LidarSelection(const std::size_t size, const bool selected = false);
+		///Selection of the echoes indices (all lower than size)
+		LidarSelection(const std::vector<EchoIndexType>& indices, const std::size_t size);
+
+		///Number of echoes (selected or not)
+		std::size_t size() const { return m_size; }
+		///Number of selected echoes
+		std::size_t count() const;
+
+		bool test(const std::size_t index) const { return (m_words[index/wordSize] >> (index%wordSize)) & 1u; }
+		bool operator[](const std::size_t index) const { return test(index); }
+		void set(const std::size_t index, const bool selected = true)
+		{
+			const WordType bit = WordType(1) << (index%wordSize);
+			if(selected)
+				m_words[index/wordSize] |= bit;
+			else
+				m_words[index/wordSize] &= ~bit;
+		}
+
+		///Same size required
+		LidarSelection& operator&=(const LidarSelection& rhs);
+		LidarSelection& operator|=(const LidarSelection& rhs);
+		///Echoes of this selection that are not in rhs
+		LidarSelection& subtract(const LidarSelection& rhs);
+		///Selects the echoes that were not selected
+		LidarSelection& flip();
+
+		const_iterator begin() const { return const_iterator(m_words.empty() ? 0 : &m_words[0], 0, m_size); }
+		const_iterator end() const { return const_iterator(m_words.empty() ? 0 : &m_words[0], m_size, m_size); }
+
+		///Indices of the selected echoes, in increasing order (for the index views)
+		void getIndices(std::vector<EchoIndexType>& indices) const;
+
+		const std::vector<WordType>& words() const { return m_words; }
+
+	private:
+		void checkSize(const LidarSelection& rhs, const char* function) const;
+
+		std::vector<WordType> m_words; //the bits after size() are always 0
+		std::size_t m_size;
+};
+
+inline LidarSelection operator&(LidarSelection lhs, const LidarSelection& rhs) { return lhs &= rhs; }
+inline LidarSelection operator|(LidarSelection lhs, const LidarSelection& rhs) { return lhs |= rhs; }
+inline LidarSelection operator~(LidarSelection selection) { return selection.flip(); }
+
+} //namespace Lidar
+
+#endif /* LIDARSELECTION_H_ */
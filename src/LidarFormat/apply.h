@@ -51,8 +51,7 @@ Contributors:
 #include <boost/preprocessor/comma_if.hpp>
 #include <boost/preprocessor/inc.hpp>
 
-#include <boost/bind.hpp>
-#include <boost/function.hpp>
+#include <stdexcept>
 
 #include <boost/preprocessor/seq/for_each.hpp>
 
@@ -75,10 +74,14 @@ Contributors:
 		#define TYPES (int8)(uint8)(int16)(uint16)(int32)(uint32)(int64)(uint64)(float32)(float64)
 
 
+		//appel direct du foncteur : pas de boost::function (ni d'allocation) par appel
 		#define SWITCH_GENERATION(r, data, TYPE)\
 			case LidarDataType::TYPE:\
-				result = boost::bind(&TFunctor<LidarDataType::TYPE>::operator(), TFunctor<LidarDataType::TYPE>() BOOST_PP_COMMA_IF(N) BOOST_PP_ENUM_SHIFTED_PARAMS_Z(1, BOOST_PP_INC(N), _) );\
-				break;
+				return TFunctor<LidarDataType::TYPE>()( BOOST_PP_ENUM_PARAMS_Z(1, N, a) );
+
+		#define SWITCH_FUNCTION_GENERATION(r, data, TYPE)\
+			case LidarDataType::TYPE:\
+				return &applyFunctor<TFunctor, LidarDataType::TYPE, R BOOST_PP_ENUM_TRAILING_PARAMS_Z(1, N, A)>;
 
 
 		template
@@ -89,21 +92,50 @@ Contributors:
 		>
 		R apply(const EnumLidarDataType switchedVariable BOOST_PP_COMMA_IF(N) BOOST_PP_ENUM_BINARY_PARAMS_Z(1, N, A, a))
 		{
-
-			boost::function<R( BOOST_PP_ENUM_PARAMS_Z(1, N, A) )> result;
 			switch(switchedVariable)
 			{
 				BOOST_PP_SEQ_FOR_EACH(SWITCH_GENERATION, N, TYPES)
 			}
 
-			return result(BOOST_PP_ENUM_PARAMS_Z(1, N, a));
+			throw std::logic_error("Error in apply : unknown attribute type !\n");
+		}
+
+		///TFunctor<T>()(a...) sous forme de fonction libre (cf. getApplyFunction)
+		template
+		<
+			template <EnumLidarDataType> class TFunctor,
+			EnumLidarDataType T,
+			typename R
+			BOOST_PP_ENUM_TRAILING_PARAMS_Z(1, N, typename A)
+		>
+		R applyFunctor(BOOST_PP_ENUM_BINARY_PARAMS_Z(1, N, A, a))
+		{
+			return TFunctor<T>()( BOOST_PP_ENUM_PARAMS_Z(1, N, a) );
+		}
+
+		///Same as apply, but returns the function instead of calling it : the type switch is done once
+		///  (e.g. once per attribute of a container), then the function is called for every echo
+		template
+		<
+			template <EnumLidarDataType> class TFunctor,
+			typename R
+			BOOST_PP_ENUM_TRAILING_PARAMS_Z(1, N, typename A)
+		>
+		R (*getApplyFunction(const EnumLidarDataType switchedVariable))( BOOST_PP_ENUM_PARAMS_Z(1, N, A) )
+		{
+			switch(switchedVariable)
+			{
+				BOOST_PP_SEQ_FOR_EACH(SWITCH_FUNCTION_GENERATION, N, TYPES)
+			}
 
+			throw std::logic_error("Error in getApplyFunction : unknown attribute type !\n");
 		}
 
 
 		#undef TYPES
 		#undef N
-		#undef SWITCH_GENERATION_NEW
+		#undef SWITCH_GENERATION
+		#undef SWITCH_FUNCTION_GENERATION
 
 
 	}
@@ -66,6 +66,8 @@ void LasIO::loadData(LidarDataContainer& lidarContainer, const XMLLidarMetaData&
 	std::cout << "Signature: " << header.GetFileSignature() << '\n';
 	std::cout << "Points count: " << header.GetPointRecordsCount() << '\n';
 
+	//only some attributes are read from the file: the others are set to 0
+	lidarContainer.clear();
 	lidarContainer.resize(header.GetPointRecordsCount());
 
 
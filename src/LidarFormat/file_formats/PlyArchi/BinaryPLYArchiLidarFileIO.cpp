@@ -40,6 +40,8 @@ Contributors:
 ***********************************************************************/
 
 
+#include <cstring>
+
 #include "LidarFormat/LidarIOFactory.h"
 #include "LidarFormat/LidarDataContainer.h"
 
@@ -91,7 +93,13 @@ void BinaryPLYArchiLidarFileIO::loadData(LidarDataContainer& lidarContainer, con
 	if(fileIn.good())
 	{
 		fileIn.seekg(endHeader, std::ios::beg);
-		fileIn.read(lidarContainer.rawData(), lidarMetaData.nbPoints_ * lidarContainer.pointSize());
+		const std::size_t nbBytes = lidarContainer.size() * lidarContainer.pointSize();
+		fileIn.read(lidarContainer.rawData(), nbBytes);
+
+		//the container is not initialized: echoes missing from the file are set to 0
+		const std::size_t nbBytesRead = fileIn.gcount();
+		if(nbBytesRead < nbBytes)
+			std::memset(lidarContainer.rawData() + nbBytesRead, 0, nbBytes - nbBytesRead);
 	}
 	else
 		throw std::logic_error("Erreur au chargement du fichier dans BinaryPLYArchiLidarFileIO::loadData : le fichier n'existe pas ou n'est pas accessible en lecture ! \n");
@@ -85,6 +85,8 @@ void TerraBINLidarFileIO::loadData(LidarDataContainer& lidarContainer, const XML
 //	cout<< "   OrgZ="<<myheader.OrgZ<<std::endl;
 //	cout<< "   Units="<<myheader.Units<<std::endl;
 
+	//only some attributes are read from the file: the others are set to 0
+	lidarContainer.clear();
 	lidarContainer.resize(myheader.PntCnt);
 
 	cout << "Taille struct : " << sizeof(TerraRgbClr) << endl;
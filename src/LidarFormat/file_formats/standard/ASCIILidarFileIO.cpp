@@ -40,6 +40,8 @@ Contributors:
 ***********************************************************************/
 
 
+#include <cstring>
+
 #include "LidarFormat/LidarIOFactory.h"
 #include "LidarFormat/LidarDataContainer.h"
 #include "LidarFormat/apply.h"
@@ -82,6 +84,36 @@ struct ReadValueFunctor<LidarDataType::uint8>
 	}
 };
 
+template<EnumLidarDataType T>
+struct WriteValueFunctor
+{
+	void operator()(std::ostream &os, const LidarConstIteratorEcho& itEcho, const unsigned int decalage)
+	{
+		os << itEcho.value<typename LidarEnumTypeTraits<T>::type>(decalage) << "\t";
+	}
+};
+
+template<>
+struct WriteValueFunctor<LidarDataType::int8>
+{
+	void operator()(std::ostream &os, const LidarConstIteratorEcho& itEcho, const unsigned int decalage)
+	{
+		os << (int) itEcho.value<int8>(decalage) << "\t";
+	}
+};
+
+template<>
+struct WriteValueFunctor<LidarDataType::uint8>
+{
+	void operator()(std::ostream &os, const LidarConstIteratorEcho& itEcho, const unsigned int decalage)
+	{
+		os << (unsigned int) itEcho.value<uint8>(decalage) << "\t";
+	}
+};
+
+typedef void (*ReadValueFunction)(std::istream &, const LidarIteratorEcho&, const unsigned int);
+typedef void (*WriteValueFunction)(std::ostream &, const LidarConstIteratorEcho&, const unsigned int);
+
 void ASCIILidarFileIO::loadData(LidarDataContainer& lidarContainer, const XMLLidarMetaData& lidarMetaData, const XMLAttributeMetaDataContainerType& attributesDescription)
 {
 	std::ifstream fileIn(lidarMetaData.binaryDataFileName_.c_str());
@@ -94,17 +126,23 @@ void ASCIILidarFileIO::loadData(LidarDataContainer& lidarContainer, const XMLLid
 	LidarIteratorEcho itbEcho = lidarContainer.begin();
 	const LidarIteratorEcho iteEcho = lidarContainer.end();
 
-	AttributeMapType::const_iterator itMapBegin = lidarContainer.getAttributeMap().begin();
-	const AttributeMapType::const_iterator ite = lidarContainer.getAttributeMap().end();
+	//fonctions de lecture résolues une fois par attribut
+	std::vector<std::pair<ReadValueFunction, unsigned int> > readPlan;
+	for(AttributeMapType::const_iterator itb = lidarContainer.getAttributeMap().begin(); itb != lidarContainer.getAttributeMap().end(); ++itb)
+		readPlan.push_back(std::make_pair(getApplyFunction<ReadValueFunctor, void, std::istream &, const LidarIteratorEcho&, const unsigned int>(itb->second.type), itb->second.decalage));
 
 	for(; (itbEcho != iteEcho) && (fileIn.good()); ++itbEcho)
 	{
-		AttributeMapType::const_iterator itb = itMapBegin;
-		for(; itb!=ite; ++itb)
+		for(std::size_t i = 0; i < readPlan.size(); ++i)
 		{
-			apply<ReadValueFunctor, void, std::istream &, const LidarIteratorEcho&, const unsigned int>(itb->second.type, fileIn, itbEcho, itb->second.decalage);
+			readPlan[i].first(fileIn, itbEcho, readPlan[i].second);
 		}
 	}
+
+	//the container is not initialized: echoes missing from the file are set to 0
+	const std::size_t nbEchosRead = itbEcho - lidarContainer.begin();
+	if(nbEchosRead < lidarContainer.size())
+		std::memset(lidarContainer.rawData(nbEchosRead), 0, (lidarContainer.size() - nbEchosRead) * lidarContainer.pointSize());
 }
 
 void ASCIILidarFileIO::save(const LidarDataContainer& lidarContainer, const std::string& binaryDataFileName)
@@ -114,11 +152,21 @@ void ASCIILidarFileIO::save(const LidarDataContainer& lidarContainer, const std:
 	if(fileOut.good())
 	{
 		fileOut.precision(12);
+
+		//même sortie que operator<<(LidarEcho), sans copier les échos
+		std::vector<std::pair<WriteValueFunction, unsigned int> > writePlan;
+		for(AttributeMapType::const_iterator it = lidarContainer.getAttributeMap().begin(); it != lidarContainer.getAttributeMap().end(); ++it)
+			writePlan.push_back(std::make_pair(getApplyFunction<WriteValueFunctor, void, std::ostream &, const LidarConstIteratorEcho&, const unsigned int>(it->second.type), it->second.decalage));
+
 		LidarConstIteratorEcho itb(lidarContainer.begin());
 		LidarConstIteratorEcho ite(lidarContainer.end());
 		for(; itb!=ite; ++itb)
 		{
-			fileOut << LidarEcho(*itb) << "\n";
+			for(std::size_t i = 0; i < writePlan.size(); ++i)
+			{
+				writePlan[i].first(fileOut, itb, writePlan[i].second);
+			}
+			fileOut << "\n";
 		}
 	}
 	else
@@ -39,6 +39,10 @@ Contributors:
  
 ***********************************************************************/
 
+#include <cstring>
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
 
 #include "LidarFormat/LidarIOFactory.h"
 #include "LidarFormat/LidarDataContainer.h"
@@ -51,31 +55,38 @@ namespace Lidar
 
 void BinaryLidarFileIO::loadData(LidarDataContainer& lidarContainer, const XMLLidarMetaData& lidarMetaData, const XMLAttributeMetaDataContainerType& attributesDescription)
 {
-	{
-		//calcul de la taille
-		std::ifstream fileIn(lidarMetaData.binaryDataFileName_.c_str(), std::ios::binary );
-		fileIn.seekg(0, std::ios::end);
-		const unsigned int tailleFicOctets = fileIn.tellg();
-		std::cout << "Taille du fichier binaire en octets : " << tailleFicOctets << std::endl;
-		const unsigned int taillePt = lidarContainer.pointSize();
-		std::cout << "Taille d'un enregistrement : " << taillePt << std::endl;
-		const unsigned int nbPts = tailleFicOctets/taillePt;
-		std::cout << "Nb de points : " << nbPts << std::endl;
-
-		if(lidarMetaData.nbPoints_ != nbPts)
-			std::cout << "Attention : la structure d'attributs du fichier xml ne correspond pas au contenu du fichier binaire !" << std::endl;
-
-
-		lidarContainer.resize(nbPts);
-	}
-
-	std::ifstream fileIn(lidarMetaData.binaryDataFileName_.c_str(), std::ios::binary);
-	if(fileIn.good())
-		fileIn.read(lidarContainer.rawData(), lidarMetaData.nbPoints_ * lidarContainer.pointSize());
-	else
-		throw std::logic_error("Erreur au chargement du fichier dans BinaryOneFileUngroupedLidarFileReader::loadData : le fichier n'existe pas ou n'est pas accessible en lecture ! \n");
+	if(!boost::filesystem::exists(lidarMetaData.binaryDataFileName_))
+		throw std::logic_error("Erreur au chargement du fichier dans BinaryLidarFileIO::loadData : le fichier n'existe pas ou n'est pas accessible en lecture ! \n");
+
+	//calcul de la taille
+	const boost::uintmax_t tailleFicOctets = boost::filesystem::file_size(lidarMetaData.binaryDataFileName_);
+	const unsigned int taillePt = lidarContainer.pointSize();
+	const std::size_t nbPts = static_cast<std::size_t>(tailleFicOctets/taillePt);
+
+	lidarContainer.resizeUninitialized(nbPts);
+
+	//chunks read concurrently straight into the container
+	const std::size_t nbBytes = lidarContainer.size() * taillePt;
+	m_readStatistics = ParallelReadStatistics();
+	const std::size_t nbBytesRead = readFileParallel(lidarMetaData.binaryDataFileName_, lidarContainer.rawData(), std::min<std::size_t>(nbBytes, lidarMetaData.nbPoints_ * taillePt), m_readOptions, &m_readStatistics);
 
+	//la structure d'attributs du fichier xml ne correspond pas au contenu du fichier binaire
+	m_readStatistics.sizeMismatch = lidarMetaData.nbPoints_ != nbPts || tailleFicOctets % taillePt != 0;
+
+	//the container is not initialized: echoes missing from the file are set to 0
+	if(nbBytesRead < nbBytes)
+		std::memset(lidarContainer.rawData() + nbBytesRead, 0, nbBytes - nbBytesRead);
+
+}
+
+void BinaryLidarFileIO::mapData(LidarDataContainer& lidarContainer, const XMLLidarMetaData& lidarMetaData, const EnumLoadingMode mode)
+{
+	//mapping past the end of the file would crash at the first access: check the size first
+	const boost::uintmax_t nbBytes = (boost::uintmax_t)lidarMetaData.nbPoints_ * lidarContainer.pointSize();
+	if(!boost::filesystem::exists(lidarMetaData.binaryDataFileName_) || boost::filesystem::file_size(lidarMetaData.binaryDataFileName_) < nbBytes)
+		throw std::logic_error("Erreur dans BinaryLidarFileIO::mapData : le fichier n'existe pas ou ne contient pas tous les points annoncés dans le xml ! \n");
 
+	lidarContainer.mapFile(lidarMetaData.binaryDataFileName_, lidarMetaData.nbPoints_, mode==mapReadOnly ? LidarDataBuffer::readOnly : LidarDataBuffer::copyOnWrite);
 }
 
 void BinaryLidarFileIO::save(const LidarDataContainer& lidarContainer, const std::string& binaryDataFileName)
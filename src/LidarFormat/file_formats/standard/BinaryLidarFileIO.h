@@ -55,6 +55,7 @@ class BinaryLidarFileIO : public LidarFileIO
 
 		virtual void loadData(LidarDataContainer& lidarContainer, const XMLLidarMetaData& lidarMetaData, const XMLAttributeMetaDataContainerType& attributesDescription);
 		virtual void save(const LidarDataContainer& lidarContainer, const std::string& binaryDataFileName);
+		virtual void mapData(LidarDataContainer& lidarContainer, const XMLLidarMetaData& lidarMetaData, const EnumLoadingMode mode);
 
 		static bool Register();
 		friend boost::shared_ptr<BinaryLidarFileIO> createBinaryLidarFileReader();
@@ -41,6 +41,7 @@ Contributors:
 
 
 #include <cmath>
+#include <vector>
 
 
 #include "LidarFormat/extern/matis/tpoint2d.h"
@@ -127,12 +128,20 @@ struct ReadValueFunctor
 {
 	typedef typename LidarEnumTypeTraits<T>::type AttributeType;
 
-	void operator()(LidarEcho &echo, const unsigned int decalage, LidarEcho &echoInitial, const unsigned int decalageInitial)
+	void operator()(LidarEcho &echo, const unsigned int decalage, const LidarConstIteratorEcho &itEchoInitial, const unsigned int decalageInitial)
 	{
-		echo.value<AttributeType>(decalage) = echoInitial.value<AttributeType>(decalageInitial);
+		echo.value<AttributeType>(decalage) = itEchoInitial.value<AttributeType>(decalageInitial);
 	}
 };
 
+typedef void (*ReadValueFunction)(LidarEcho&, const unsigned int, const LidarConstIteratorEcho&, const unsigned int);
+
+struct CopyAttribute
+{
+	ReadValueFunction read;
+	unsigned int decalage, decalageInitial;
+};
+
 
 template<EnumLidarDataType TAttributeType>
 struct FunctorCenter
@@ -159,34 +168,44 @@ struct FunctorCenter
 		if(transfo.x()==0 && transfo.y()==0)
 		{
 			const float quotient = 1000.;
-			LidarEcho echoInitial(*itb);
-			double x = std::floor(echoInitial.value<AttributeType>(decalageX_initial)/quotient)*quotient;
-			double y = std::floor(echoInitial.value<AttributeType>(decalageY_initial)/quotient)*quotient;
+			double x = std::floor(itb.value<AttributeType>(decalageX_initial)/quotient)*quotient;
+			double y = std::floor(itb.value<AttributeType>(decalageY_initial)/quotient)*quotient;
 			transfo.setTransfo(x,y);
 		}
 
 
-		for(;itb!=ite; ++itb)
-		{
-			LidarEcho echoInitial(*itb);
+		//copie des autres attributs : fonctions et décalages résolus une fois pour tous les échos
+		std::vector<CopyAttribute> copyPlan;
 
-			echo.value<float>(decalageX) = (float)( echoInitial.value<AttributeType>(decalageX_initial) - transfo.x() );
-			echo.value<float>(decalageY) = (float)( echoInitial.value<AttributeType>(decalageY_initial) - transfo.y() );
-			echo.value<float>(decalageZ) = (float)echoInitial.value<AttributeType>(decalageZ_initial);
+		AttributeMapType::const_iterator itbAttribute = centeredContainer->getAttributeMap().begin();
+		const AttributeMapType::const_iterator iteAttribute = centeredContainer->getAttributeMap().end();
 
-			AttributeMapType::const_iterator itbAttribute = centeredContainer->getAttributeMap().begin();
-			const AttributeMapType::const_iterator iteAttribute = centeredContainer->getAttributeMap().end();
+		AttributeMapType::const_iterator itbAttributeInitial = lidarContainer.getAttributeMap().begin();
 
-			AttributeMapType::const_iterator itbAttributeInitial = lidarContainer.getAttributeMap().begin();
-
-			for(; itbAttribute != iteAttribute; ++itbAttribute, ++itbAttributeInitial)
+		for(; itbAttribute != iteAttribute; ++itbAttribute, ++itbAttributeInitial)
+		{
+			if(itbAttribute->first!=x && itbAttribute->first!=y && itbAttribute->first!=z)
 			{
-				if(itbAttribute->first!=x && itbAttribute->first!=y && itbAttribute->first!=z)
-				{
-					apply<ReadValueFunctor, void, LidarEcho&, const unsigned int, LidarEcho&, const unsigned int>(itbAttribute->second.type, echo, itbAttribute->second.decalage, echoInitial, itbAttributeInitial->second.decalage);
-				}
+				CopyAttribute copy;
+				copy.read = getApplyFunction<ReadValueFunctor, void, LidarEcho&, const unsigned int, const LidarConstIteratorEcho&, const unsigned int>(itbAttribute->second.type);
+				copy.decalage = itbAttribute->second.decalage;
+				copy.decalageInitial = itbAttributeInitial->second.decalage;
+				copyPlan.push_back(copy);
 			}
+		}
+
 
+		for(;itb!=ite; ++itb)
+		{
+			//lecture directe par l'itérateur : pas de copie de l'écho initial
+			echo.value<float>(decalageX) = (float)( itb.value<AttributeType>(decalageX_initial) - transfo.x() );
+			echo.value<float>(decalageY) = (float)( itb.value<AttributeType>(decalageY_initial) - transfo.y() );
+			echo.value<float>(decalageZ) = (float)itb.value<AttributeType>(decalageZ_initial);
+
+			for(std::size_t i = 0; i < copyPlan.size(); ++i)
+			{
+				copyPlan[i].read(echo, copyPlan[i].decalage, itb, copyPlan[i].decalageInitial);
+			}
 
 			centeredContainer->push_back(echo);
 		}
@@ -65,7 +65,7 @@ void LidarSpatialIndexation2D::GetCenteredNeighborhood(NeighborhoodListeType &li
 	const int ligMin = std::max( 0, ligne - tailleVoisinage );
 	const int ligMax = std::min( m_griddedData.GetTaille().y - 1, ligne + tailleVoisinage );
 
-	const unsigned int evalNbPoints = (unsigned int)( (colMax-colMin+1)*(ligMax-ligMin+1)*m_resolution*m_nbPointsParM2 );
+	const std::size_t evalNbPoints = (std::size_t)( (colMax-colMin+1)*(ligMax-ligMin+1)*m_resolution*m_nbPointsParM2 );
 	list.reserve(evalNbPoints);
 
 	const LidarConstIteratorXYZ<float> beginXYZ = m_lidarContainer.beginXYZ<float>();
@@ -74,8 +74,8 @@ void LidarSpatialIndexation2D::GetCenteredNeighborhood(NeighborhoodListeType &li
 	{
 		for (int lig = ligMin; lig <= ligMax; ++lig)
 		{
-			std::vector<unsigned int>::const_iterator itb = m_griddedData(col, lig).begin();
-			const std::vector<unsigned int>::const_iterator ite = m_griddedData(col, lig).end();
+			NeighborhoodListeType::const_iterator itb = m_griddedData(col, lig).begin();
+			const NeighborhoodListeType::const_iterator ite = m_griddedData(col, lig).end();
 			for (; itb != ite; ++itb)
 			{
 				const LidarConstIteratorXYZ<float> itXYZ(beginXYZ + *itb);
@@ -129,7 +129,7 @@ void LidarSpatialIndexation2D::fillData()
 //		std::cout << *itx << "\t" << *ity << "\t" << col << "\t" << ligne << std::endl;
 		//dans le cas où la bbox n'a pas été calculée mais fournie dan le constructeur, il faut tester si on sort de la grille
 		if(col>=0 && ligne>=0 && col<m_griddedData.GetTaille().x && ligne<m_griddedData.GetTaille().y)
-			m_griddedData(col, ligne).push_back(itb - itbegin);
+			m_griddedData(col, ligne).push_back(static_cast<EchoIndexType>(itb - itbegin));
 	}
 
 }
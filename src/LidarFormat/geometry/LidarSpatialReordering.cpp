@@ -0,0 +1,242 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+
+#include "LidarFormat/LidarDataContainer.h"
+#include "LidarFormat/apply.h"
+#include "LidarFormat/tools/ParallelFor.h"
+#include "LidarFormat/tools/RadixSort.h"
+
+#include "LidarSpatialReordering.h"
+
+namespace Lidar
+{
+
+namespace
+{
+
+template<EnumLidarDataType T>
+struct ReadAsDoubleFunctor
+{
+	double operator()(const char* data)
+	{
+		typename LidarEnumTypeTraits<T>::type value;
+		std::memcpy(&value, data, sizeof(value));
+		return static_cast<double>(value);
+	}
+};
+
+typedef double (*ReadAsDoubleFunction)(const char*);
+
+///Hilbert transpose of the cell coordinates (J. Skilling, "Programming the Hilbert curve", 2004)
+void axesToTranspose(uint32* X, const unsigned int nbBits, const unsigned int nbDims)
+{
+	const uint32 M = static_cast<uint32>(1) << (nbBits-1);
+
+	//inverse undo
+	for(uint32 Q = M; Q > 1; Q >>= 1)
+	{
+		const uint32 P = Q - 1;
+		for(unsigned int i = 0; i < nbDims; ++i)
+		{
+			if(X[i] & Q)
+				X[0] ^= P;
+			else
+			{
+				const uint32 t = (X[0] ^ X[i]) & P;
+				X[0] ^= t;
+				X[i] ^= t;
+			}
+		}
+	}
+
+	//Gray encode
+	for(unsigned int i = 1; i < nbDims; ++i)
+		X[i] ^= X[i-1];
+
+	uint32 t = 0;
+	for(uint32 Q = M; Q > 1; Q >>= 1)
+		if(X[nbDims-1] & Q)
+			t ^= Q - 1;
+
+	for(unsigned int i = 0; i < nbDims; ++i)
+		X[i] ^= t;
+}
+
+///Bits of the coordinates interleaved, from the most significant ones (X[0] first)
+uint64 interleave(const uint32* X, const unsigned int nbBits, const unsigned int nbDims)
+{
+	uint64 key = 0;
+	for(int bit = nbBits-1; bit >= 0; --bit)
+		for(unsigned int i = 0; i < nbDims; ++i)
+			key = (key << 1) | ((X[i] >> bit) & 1);
+	return key;
+}
+
+struct CurveKeyFunctor
+{
+	const char* data;
+	unsigned int pointSize;
+	ReadAsDoubleFunction read[3];
+	unsigned int decalage[3];
+	double mini[3];
+	double cellSize;
+	uint32 maxCell;
+	unsigned int nbDims, nbBits;
+	bool hilbert;
+	uint64* keys;
+	EchoIndexType* indices;
+
+	void operator()(const std::size_t first, const std::size_t last) const
+	{
+		uint32 cell[3];
+		for(std::size_t i = first; i < last; ++i)
+		{
+			const char* echo = data + i*pointSize;
+			for(unsigned int d = 0; d < nbDims; ++d)
+				cell[d] = static_cast<uint32>(std::min<double>(maxCell, (read[d](echo + decalage[d]) - mini[d]) / cellSize));
+
+			if(hilbert)
+				axesToTranspose(cell, nbBits, nbDims);
+
+			keys[i] = interleave(cell, nbBits, nbDims);
+			indices[i] = static_cast<EchoIndexType>(i);
+		}
+	}
+};
+
+} //namespace
+
+
+LidarSpatialReordering::LidarSpatialReordering(const double cellSize, const CurveType curve):
+	m_cellSize(cellSize), m_curve(curve), m_use3D(false), m_x("x"), m_y("y"), m_z("z"), m_nbThreads(1)
+{
+}
+
+void LidarSpatialReordering::computePermutation(const LidarDataContainer& lidarContainer, std::vector<EchoIndexType>& permutation) const
+{
+	if(m_cellSize <= 0)
+		throw std::logic_error("Error in LidarSpatialReordering::computePermutation : the size of the cells must be positive !\n");
+
+	CurveKeyFunctor f;
+	f.nbDims = m_use3D ? 3 : 2;
+	f.nbBits = m_use3D ? 21 : 32;
+	f.hilbert = m_curve == hilbert;
+
+	const std::string names[3] = { m_x, m_y, m_z };
+	for(unsigned int d = 0; d < f.nbDims; ++d)
+	{
+		const AttributeMapType::const_iterator it = lidarContainer.getAttributeMap().find(names[d]);
+		if(it == lidarContainer.getAttributeMap().end())
+			throw std::logic_error("Error in LidarSpatialReordering::computePermutation : attribute " + names[d] + " is not present !\n");
+
+		f.read[d] = getApplyFunction<ReadAsDoubleFunctor, double, const char*>(it->second.type);
+		f.decalage[d] = it->second.decalage;
+	}
+
+	const std::size_t nbEchos = lidarContainer.size();
+	if(nbEchos > static_cast<std::size_t>(std::numeric_limits<EchoIndexType>::max()))
+		throw std::logic_error("Error in LidarSpatialReordering::computePermutation : too many echoes for EchoIndexType (see LIDARFORMAT_COMPACT_INDEX) !\n");
+
+	permutation.resize(nbEchos);
+	if(nbEchos == 0)
+		return;
+
+	f.data = lidarContainer.rawData();
+	f.pointSize = lidarContainer.pointSize();
+
+	//bounding box
+	double maxi[3];
+	for(unsigned int d = 0; d < f.nbDims; ++d)
+		f.mini[d] = maxi[d] = f.read[d](f.data + f.decalage[d]);
+
+	for(std::size_t i = 1; i < nbEchos; ++i)
+	{
+		const char* echo = f.data + i*f.pointSize;
+		for(unsigned int d = 0; d < f.nbDims; ++d)
+		{
+			const double value = f.read[d](echo + f.decalage[d]);
+			f.mini[d] = std::min(f.mini[d], value);
+			maxi[d] = std::max(maxi[d], value);
+		}
+	}
+
+	//cells enlarged if the grid needs more than nbBits per axis
+	f.maxCell = static_cast<uint32>((static_cast<uint64>(1) << f.nbBits) - 1);
+	f.cellSize = m_cellSize;
+	for(unsigned int d = 0; d < f.nbDims; ++d)
+		f.cellSize = std::max(f.cellSize, (maxi[d] - f.mini[d]) / f.maxCell);
+
+	std::vector<uint64> keys(nbEchos);
+	f.keys = &keys[0];
+	f.indices = &permutation[0];
+	parallelFor(0, nbEchos, f, m_nbThreads);
+
+	radixSort(keys, permutation, m_nbThreads);
+}
+
+void LidarSpatialReordering::reorder(LidarDataContainer& lidarContainer) const
+{
+	//index before the first reordering, kept by the next ones
+	if(!m_originalIndexAttribute.empty() && !lidarContainer.checkAttributeIsPresent(m_originalIndexAttribute))
+	{
+		//copied first: the pair constructor takes a reference, and enum_type has no definition out of its class
+		const EnumLidarDataType indexType = LidarTypeTraits<EchoIndexType>::enum_type;
+		lidarContainer.addAttributes(LidarDataContainer::AttributeListType(1, LidarDataContainer::AttributeListType::value_type(m_originalIndexAttribute, indexType)), m_nbThreads);
+
+		EchoIndexType index = 0;
+		const LidarIteratorAttribute<EchoIndexType> ite = lidarContainer.endAttribute<EchoIndexType>(m_originalIndexAttribute);
+		for(LidarIteratorAttribute<EchoIndexType> it = lidarContainer.beginAttribute<EchoIndexType>(m_originalIndexAttribute); it != ite; ++it, ++index)
+			*it = index;
+	}
+
+	std::vector<EchoIndexType> permutation;
+	computePermutation(lidarContainer, permutation);
+	lidarContainer.applyPermutation(permutation, m_nbThreads);
+}
+
+} //namespace Lidar
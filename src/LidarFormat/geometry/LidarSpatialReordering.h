@@ -0,0 +1,100 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef LIDARSPATIALREORDERING_H_
+#define LIDARSPATIALREORDERING_H_
+
+#include <string>
+#include <vector>
+
+#include "LidarFormat/LidarDataFormatTypes.h"
+
+
+namespace Lidar
+{
+
+class LidarDataContainer;
+
+/**
+* @brief Reorders the echoes of a container along a space filling curve (Morton or Hilbert) over a grid of cells,
+* so that spatially close points are close in memory (same cache lines and pages for neighborhood queries and crops)
+*
+* The cells are computed on x/y (or x/y/z with setUse3D), with 32 bits per axis in 2D and 21 bits in 3D :
+* the cells are enlarged if the bounding box needs more.
+*
+*/
+class LidarSpatialReordering
+{
+	public:
+		enum CurveType
+		{
+			morton,
+			hilbert
+		};
+
+		explicit LidarSpatialReordering(const double cellSize = 1., const CurveType curve = hilbert);
+
+		void setUse3D(const bool use3D) { m_use3D = use3D; }
+		///If not empty, attribute added to the container with the index of each echo before the first reordering (type EchoIndexType)
+		void setOriginalIndexAttribute(const std::string& attributeName) { m_originalIndexAttribute = attributeName; }
+		void setAttributeNames(const std::string& x, const std::string& y, const std::string& z) { m_x = x; m_y = y; m_z = z; }
+		///Threads used to compute and sort the keys and to move the echoes (0 : one per core)
+		void setNbThreads(const unsigned int nbThreads) { m_nbThreads = nbThreads; }
+
+		///Permutation of the echoes along the curve (see LidarDataContainer::applyPermutation)
+		void computePermutation(const LidarDataContainer& lidarContainer, std::vector<EchoIndexType>& permutation) const;
+
+		void reorder(LidarDataContainer& lidarContainer) const;
+
+	private:
+		double m_cellSize;
+		CurveType m_curve;
+		bool m_use3D;
+		std::string m_originalIndexAttribute;
+		std::string m_x, m_y, m_z;
+		unsigned int m_nbThreads;
+};
+
+} //namespace Lidar
+
+#endif /* LIDARSPATIALREORDERING_H_ */
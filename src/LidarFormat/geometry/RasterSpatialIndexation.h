@@ -52,6 +52,7 @@ Contributors:
 //#include "outils/stl_tools.h"
 //
 #include "LidarFormat/tools/Orientation2D.h"
+#include "LidarFormat/LidarDataFormatTypes.h"
 //#include "itk/Image.h"
 //
 //#include "outils/OutilsMaths.h"
@@ -76,8 +77,9 @@ namespace Lidar
 class RasterSpatialIndexation
 {
 	public:
-		typedef std::vector<unsigned int> NeighborhoodListeType;
-		typedef TTableau2D<std::vector<unsigned int> > GriddedDataType;
+		///Indices des points (32 bits en mode compact, voir EchoIndexType)
+		typedef std::vector<EchoIndexType> NeighborhoodListeType;
+		typedef TTableau2D<std::vector<EchoIndexType> > GriddedDataType;
 
 
 		typedef boost::function<bool(const float, const float, const float)> NeighborhoodFunctionType;
@@ -93,7 +95,7 @@ class RasterSpatialIndexation
 		{ return true; }
 
 		///Fonction de calcul de voisinage par défaut; renvoit true à l'intérieur du voisinage
-		static bool allPointsFilter(const unsigned int)
+		static bool allPointsFilter(const EchoIndexType)
 		{ return true; }
 
 
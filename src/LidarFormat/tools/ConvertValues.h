@@ -0,0 +1,101 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef CONVERTVALUES_H_
+#define CONVERTVALUES_H_
+
+#include <cstddef>
+
+#include "LidarFormat/LidarDataFormatTypes.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+
+namespace Lidar
+{
+
+///destination[k] = static_cast<To>(source[k]*scale + offset), computed in double, for k in [0, n)
+///  with AVX, double to float (and uint16 to float with AVX2, see the CMake option ENABLE_AVX2) are converted 4 values at a time
+template<typename To, typename From>
+inline void convertValues(const From* source, const std::size_t n, const double scale, const double offset, To* destination)
+{
+	for(std::size_t k = 0; k < n; ++k)
+		destination[k] = static_cast<To>(source[k]*scale + offset);
+}
+
+#if defined(__AVX__)
+template<>
+inline void convertValues<float32, float64>(const float64* source, const std::size_t n, const double scale, const double offset, float32* destination)
+{
+	const __m256d s = _mm256_set1_pd(scale);
+	const __m256d o = _mm256_set1_pd(offset);
+	std::size_t k = 0;
+	for(; k + 4 <= n; k += 4)
+		_mm_storeu_ps(destination + k, _mm256_cvtpd_ps(_mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(source + k), s), o)));
+	for(; k < n; ++k)
+		destination[k] = static_cast<float32>(source[k]*scale + offset);
+}
+#endif
+
+#if defined(__AVX2__)
+template<>
+inline void convertValues<float32, uint16>(const uint16* source, const std::size_t n, const double scale, const double offset, float32* destination)
+{
+	const __m256d s = _mm256_set1_pd(scale);
+	const __m256d o = _mm256_set1_pd(offset);
+	std::size_t k = 0;
+	for(; k + 4 <= n; k += 4)
+	{
+		const __m256d values = _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + k))));
+		_mm_storeu_ps(destination + k, _mm256_cvtpd_ps(_mm256_add_pd(_mm256_mul_pd(values, s), o)));
+	}
+	for(; k < n; ++k)
+		destination[k] = static_cast<float32>(source[k]*scale + offset);
+}
+#endif
+
+} //namespace Lidar
+
+#endif /* CONVERTVALUES_H_ */
@@ -0,0 +1,210 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef PARALLELALGORITHMS_H_
+#define PARALLELALGORITHMS_H_
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include "LidarFormat/tools/ThreadPool.h"
+
+
+namespace Lidar
+{
+
+/**
+* Parallel loops over the elements of a range : LidarDataContainer, LidarDataSlice, LidarDataAttView,
+* LidarDataAttProxyView, LidarDataAttProxyIndexView... (anything with random access begin() and end()).
+*
+* The elements are split in chunks of chunkSize elements, run on nbThreads threads of ThreadPool::defaultPool()
+* (0 : one per core), with work stealing between the threads. The functors are copied for each chunk,
+* are called from several threads at once and must not throw.
+*/
+
+///Elements per chunk by default : about 256 kB of echoes of 32 bytes, which stays in the L2 cache
+static const std::size_t defaultChunkSize = 8192;
+
+namespace detail
+{
+
+template<typename Iterator>
+struct _ParallelChunks
+{
+	_ParallelChunks(const Iterator& first, const std::size_t size, const std::size_t chunkSize):
+		first_(first), size_(size), chunkSize_(std::max<std::size_t>(1, chunkSize)) {}
+
+	std::size_t nbChunks() const { return (size_ + chunkSize_ - 1) / chunkSize_; }
+	std::size_t begin(const std::size_t chunk) const { return chunk*chunkSize_; }
+	std::size_t end(const std::size_t chunk) const { return std::min(size_, (chunk+1)*chunkSize_); }
+
+	Iterator first_;
+	std::size_t size_;
+	std::size_t chunkSize_;
+};
+
+template<typename Iterator, typename Functor>
+struct _ForEachTask : public _ThreadPoolTask
+{
+	_ForEachTask(const _ParallelChunks<Iterator>& chunks, const Functor& f): chunks_(chunks), f_(f) {}
+
+	void operator()(const std::size_t chunk) const
+	{
+		Functor f(f_);
+		Iterator it = chunks_.first_ + chunks_.begin(chunk);
+		for(std::size_t i = chunks_.begin(chunk); i < chunks_.end(chunk); ++i, ++it)
+			f(*it);
+	}
+
+	_ParallelChunks<Iterator> chunks_;
+	const Functor& f_;
+};
+
+template<typename Iterator, typename OutputIterator, typename Functor>
+struct _TransformTask : public _ThreadPoolTask
+{
+	_TransformTask(const _ParallelChunks<Iterator>& chunks, const OutputIterator& result, const Functor& f): chunks_(chunks), result_(result), f_(f) {}
+
+	void operator()(const std::size_t chunk) const
+	{
+		Functor f(f_);
+		Iterator it = chunks_.first_ + chunks_.begin(chunk);
+		OutputIterator out = result_ + chunks_.begin(chunk);
+		for(std::size_t i = chunks_.begin(chunk); i < chunks_.end(chunk); ++i, ++it, ++out)
+			*out = f(*it);
+	}
+
+	_ParallelChunks<Iterator> chunks_;
+	OutputIterator result_;
+	const Functor& f_;
+};
+
+//partial result of a chunk : wrapped so that std::vector<bool> never packs the results of several chunks in one word
+template<typename T>
+struct _Partial
+{
+	explicit _Partial(const T& value): value_(value) {}
+	T value_;
+};
+
+//partial result of each chunk, from init
+template<typename Iterator, typename T, typename Reduce, typename Transform>
+struct _TransformReduceTask : public _ThreadPoolTask
+{
+	_TransformReduceTask(const _ParallelChunks<Iterator>& chunks, const T& init, const Reduce& reduce, const Transform& transform, std::vector<_Partial<T> >& partials):
+		chunks_(chunks), init_(init), reduce_(reduce), transform_(transform), partials_(partials) {}
+
+	void operator()(const std::size_t chunk) const
+	{
+		Reduce reduce(reduce_);
+		Transform transform(transform_);
+		T result = init_;
+		Iterator it = chunks_.first_ + chunks_.begin(chunk);
+		for(std::size_t i = chunks_.begin(chunk); i < chunks_.end(chunk); ++i, ++it)
+			result = reduce(result, transform(*it));
+		partials_[chunk].value_ = result;
+	}
+
+	_ParallelChunks<Iterator> chunks_;
+	const T& init_;
+	const Reduce& reduce_;
+	const Transform& transform_;
+	std::vector<_Partial<T> >& partials_;
+};
+
+struct _Identity
+{
+	template<typename T> const T& operator()(const T& value) const { return value; }
+};
+
+template<typename Range>
+_ParallelChunks<typename Range::iterator> _makeChunks(Range& range, const std::size_t chunkSize)
+{
+	const typename Range::iterator first = range.begin();
+	return _ParallelChunks<typename Range::iterator>(first, static_cast<std::size_t>(range.end() - first), chunkSize);
+}
+
+} //namespace detail
+
+///Calls f(*it) for each element of range
+template<typename Range, typename Functor>
+void parallel_for_each(Range& range, Functor f, const unsigned int nbThreads = 0, const std::size_t chunkSize = defaultChunkSize)
+{
+	const detail::_ParallelChunks<typename Range::iterator> chunks = detail::_makeChunks(range, chunkSize);
+	ThreadPool::defaultPool().run(chunks.nbChunks(), detail::_ForEachTask<typename Range::iterator, Functor>(chunks, f), nbThreads);
+}
+
+///result[i] = f(range[i]) (random access result, it may be the begin() of a view on the same container)
+template<typename Range, typename OutputIterator, typename Functor>
+void parallel_transform(Range& range, OutputIterator result, Functor f, const unsigned int nbThreads = 0, const std::size_t chunkSize = defaultChunkSize)
+{
+	const detail::_ParallelChunks<typename Range::iterator> chunks = detail::_makeChunks(range, chunkSize);
+	ThreadPool::defaultPool().run(chunks.nbChunks(), detail::_TransformTask<typename Range::iterator, OutputIterator, Functor>(chunks, result, f), nbThreads);
+}
+
+///reduce(... reduce(reduce(init, transform(range[0])), transform(range[1])) ...)
+///  each chunk starts from init, which must be neutral for reduce ; the results of the chunks are reduced in order
+template<typename Range, typename T, typename Reduce, typename Transform>
+T parallel_transform_reduce(Range& range, const T& init, Reduce reduce, Transform transform, const unsigned int nbThreads = 0, const std::size_t chunkSize = defaultChunkSize)
+{
+	const detail::_ParallelChunks<typename Range::iterator> chunks = detail::_makeChunks(range, chunkSize);
+	std::vector<detail::_Partial<T> > partials(chunks.nbChunks(), detail::_Partial<T>(init));
+	ThreadPool::defaultPool().run(chunks.nbChunks(), detail::_TransformReduceTask<typename Range::iterator, T, Reduce, Transform>(chunks, init, reduce, transform, partials), nbThreads);
+
+	T result = init;
+	for(typename std::vector<detail::_Partial<T> >::const_iterator it = partials.begin(); it != partials.end(); ++it)
+		result = reduce(result, it->value_);
+	return result;
+}
+
+///Same as parallel_transform_reduce, on the elements themselves (reduce(T, element) and reduce(T, T))
+template<typename Range, typename T, typename Reduce>
+T parallel_reduce(Range& range, const T& init, Reduce reduce, const unsigned int nbThreads = 0, const std::size_t chunkSize = defaultChunkSize)
+{
+	return parallel_transform_reduce(range, init, reduce, detail::_Identity(), nbThreads, chunkSize);
+}
+
+} //namespace Lidar
+
+#endif /* PARALLELALGORITHMS_H_ */
@@ -0,0 +1,250 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <fstream>
+#include <ostream>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+#include "LidarFormat/tools/ThreadPool.h"
+#include "LidarFormat/tools/ParallelFileReader.h"
+
+
+namespace Lidar
+{
+
+std::ostream& operator<<(std::ostream& os, const ParallelReadStatistics& statistics)
+{
+	os << statistics.nbBytes/1048576. << " MB in " << statistics.seconds << " s (" << statistics.throughput()/1048576. << " MB/s, "
+	   << statistics.nbChunks << " chunks, " << statistics.nbThreads << " threads" << (statistics.directIO ? ", O_DIRECT" : "")
+	   << (statistics.sizeMismatch ? ", file size mismatch)" : ")");
+	return os;
+}
+
+#if defined(_POSIX_VERSION)
+
+namespace
+{
+
+//pread until size bytes, the end of the file or an error (error set to errno)
+//  an O_DIRECT read shorter than the alignment can only be the end of the file : the next offset would not be aligned
+std::size_t preadAll(const int fd, char* buffer, const std::size_t size, const std::size_t offset, const bool direct, int& error)
+{
+	std::size_t done = 0;
+	while(done < size)
+	{
+		const ssize_t n = ::pread(fd, buffer + done, size - done, static_cast<off_t>(offset + done));
+		if(n < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			error = errno;
+			break;
+		}
+		if(n == 0)
+			break;
+		done += static_cast<std::size_t>(n);
+		if(direct && done % directIOAlignment != 0)
+			break;
+	}
+	return done;
+}
+
+//reads one chunk of the file at its place in destination
+struct ReadChunkTask : public detail::_ThreadPoolTask
+{
+	ReadChunkTask(const int fd, const int directFd, char* destination, const std::size_t nbBytes, const std::size_t chunkSize, const bool noReuse, std::size_t* bytesRead, int* errors):
+		fd_(fd), directFd_(directFd), destination_(destination), nbBytes_(nbBytes), chunkSize_(chunkSize), noReuse_(noReuse), bytesRead_(bytesRead), errors_(errors) {}
+
+	void operator()(const std::size_t chunk) const
+	{
+		const std::size_t offset = chunk*chunkSize_;
+		const std::size_t size = std::min(chunkSize_, nbBytes_ - offset);
+		char* const target = destination_ + offset;
+		int error = 0;
+		std::size_t done = 0;
+
+		if(directFd_ >= 0)
+		{
+			const std::size_t alignedSize = (size + directIOAlignment - 1) / directIOAlignment * directIOAlignment;
+			if(reinterpret_cast<std::size_t>(target) % directIOAlignment == 0 && alignedSize == size)
+				done = preadAll(directFd_, target, size, offset, true, error);
+			else
+			{
+				void* buffer = 0;
+				if(posix_memalign(&buffer, directIOAlignment, alignedSize) == 0)
+				{
+					done = std::min(size, preadAll(directFd_, static_cast<char*>(buffer), alignedSize, offset, true, error));
+					std::memcpy(target, buffer, done);
+					std::free(buffer);
+				}
+				else
+					error = EINVAL;
+			}
+
+			//some file systems accept O_DIRECT at open but not for reading
+			if(error == EINVAL)
+			{
+				error = 0;
+				done = preadAll(fd_, target, size, offset, false, error);
+			}
+		}
+		else
+		{
+			done = preadAll(fd_, target, size, offset, false, error);
+#if defined(POSIX_FADV_DONTNEED)
+			if(noReuse_)
+				posix_fadvise(fd_, static_cast<off_t>(offset), static_cast<off_t>(size), POSIX_FADV_DONTNEED);
+#endif
+		}
+
+		bytesRead_[chunk] = done;
+		errors_[chunk] = error;
+	}
+
+	int fd_;
+	int directFd_;
+	char* destination_;
+	std::size_t nbBytes_;
+	std::size_t chunkSize_;
+	bool noReuse_;
+	std::size_t* bytesRead_;
+	int* errors_;
+};
+
+} //namespace
+
+std::size_t readFileParallel(const std::string& fileName, char* destination, const std::size_t nbBytes, const ParallelReadOptions& options, ParallelReadStatistics* statistics)
+{
+	const boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+	const int fd = ::open(fileName.c_str(), O_RDONLY);
+	if(fd < 0)
+		throw std::logic_error("Error in readFileParallel : cannot open " + fileName + " (" + std::strerror(errno) + ") !\n");
+
+	int directFd = -1;
+#if defined(O_DIRECT)
+	if(options.cacheMode == readDirect)
+		directFd = ::open(fileName.c_str(), O_RDONLY | O_DIRECT);
+#endif
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+	if(options.cacheMode == readSequential)
+		posix_fadvise(fd, 0, static_cast<off_t>(nbBytes), POSIX_FADV_SEQUENTIAL);
+#endif
+
+	const std::size_t chunkSize = std::max<std::size_t>(1, (options.chunkSize + directIOAlignment - 1) / directIOAlignment) * directIOAlignment;
+	const std::size_t nbChunks = (nbBytes + chunkSize - 1) / chunkSize;
+	const unsigned int nbThreads = static_cast<unsigned int>(std::min<std::size_t>(options.nbThreads ? options.nbThreads : defaultNbThreads(), std::max<std::size_t>(1, nbChunks)));
+
+	std::vector<std::size_t> bytesRead(nbChunks, 0);
+	std::vector<int> errors(nbChunks, 0);
+	if(nbChunks > 0)
+		ThreadPool::defaultPool().run(nbChunks, ReadChunkTask(fd, directFd, destination, nbBytes, chunkSize, options.cacheMode == readNoReuse, &bytesRead[0], &errors[0]), nbThreads);
+
+	if(directFd >= 0)
+		::close(directFd);
+	::close(fd);
+
+	//the data read is contiguous up to the first short chunk (end of the file)
+	std::size_t total = 0;
+	for(std::size_t chunk = 0; chunk < nbChunks; ++chunk)
+	{
+		if(errors[chunk] != 0)
+			throw std::logic_error("Error in readFileParallel : cannot read " + fileName + " (" + std::strerror(errors[chunk]) + ") !\n");
+		total += bytesRead[chunk];
+		if(bytesRead[chunk] < std::min(chunkSize, nbBytes - chunk*chunkSize))
+			break;
+	}
+
+	if(statistics)
+	{
+		statistics->nbBytes = total;
+		statistics->nbChunks = nbChunks;
+		statistics->nbThreads = nbThreads;
+		statistics->seconds = (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds() * 1e-6;
+		statistics->directIO = directFd >= 0;
+	}
+
+	return total;
+}
+
+#else
+
+std::size_t readFileParallel(const std::string& fileName, char* destination, const std::size_t nbBytes, const ParallelReadOptions& options, ParallelReadStatistics* statistics)
+{
+	const boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+	std::ifstream fileIn(fileName.c_str(), std::ios::binary);
+	if(!fileIn.good())
+		throw std::logic_error("Error in readFileParallel : cannot open " + fileName + " !\n");
+	fileIn.read(destination, static_cast<std::streamsize>(nbBytes));
+	const std::size_t total = static_cast<std::size_t>(fileIn.gcount());
+
+	if(statistics)
+	{
+		statistics->nbBytes = total;
+		statistics->nbChunks = 1;
+		statistics->nbThreads = 1;
+		statistics->seconds = (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds() * 1e-6;
+		statistics->directIO = false;
+	}
+
+	return total;
+}
+
+#endif
+
+} //namespace Lidar
@@ -0,0 +1,109 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef PARALLELFILEREADER_H_
+#define PARALLELFILEREADER_H_
+
+#include <cstddef>
+#include <string>
+#include <iosfwd>
+
+
+namespace Lidar
+{
+
+///How readFileParallel uses the page cache
+enum EnumReadCacheMode
+{
+	readCached, ///< plain reads through the page cache
+	readSequential, ///< posix_fadvise(POSIX_FADV_SEQUENTIAL) : larger read-ahead
+	readNoReuse, ///< the pages of each chunk are dropped from the cache once read (file read once)
+	readDirect ///< O_DIRECT : no page cache (plain reads if the file system refuses it), see readFileParallel for the alignment
+};
+
+struct ParallelReadOptions
+{
+	ParallelReadOptions(): chunkSize(8u << 20), nbThreads(0), cacheMode(readSequential) {}
+	std::size_t chunkSize; ///< bytes per pread, rounded up to a multiple of directIOAlignment
+	unsigned int nbThreads; ///< 0 : one per core
+	EnumReadCacheMode cacheMode;
+};
+
+///What readFileParallel actually did
+struct ParallelReadStatistics
+{
+	ParallelReadStatistics(): nbBytes(0), nbChunks(0), nbThreads(0), seconds(0.), directIO(false), sizeMismatch(false) {}
+	///Bytes read per second (0 if nothing was timed)
+	double throughput() const { return seconds > 0. ? nbBytes/seconds : 0.; }
+
+	std::size_t nbBytes;
+	std::size_t nbChunks;
+	unsigned int nbThreads;
+	double seconds;
+	bool directIO;
+	///Set by the file readers : the size of the file does not match the number of echoes of its metadata
+	bool sizeMismatch;
+};
+
+std::ostream& operator<<(std::ostream& os, const ParallelReadStatistics& statistics);
+
+///Alignment of the offsets, sizes and buffers of O_DIRECT reads
+static const std::size_t directIOAlignment = 4096;
+
+/**
+* Reads the first nbBytes of fileName into destination. The file is cut in chunks of options.chunkSize bytes,
+* read concurrently with pread on the threads of ThreadPool::defaultPool(), each one directly at its place in destination
+* (through an aligned buffer for the O_DIRECT reads that cannot be done in place).
+*
+* O_DIRECT reads are done in place only for page-aligned chunks : destination aligned on directIOAlignment and a chunk size
+* multiple of it. The storage of the containers is only aligned on LidarDataAllocator::alignment, except the blocks mapped
+* by HugePageAllocator : with the default allocator, each chunk goes through the aligned buffer (one more copy).
+*
+* Returns the number of bytes read, less than nbBytes if the file is shorter ; throws if the file cannot be opened or read.
+* Without pread (non POSIX systems), the file is read by a single std::ifstream::read.
+*/
+std::size_t readFileParallel(const std::string& fileName, char* destination, const std::size_t nbBytes, const ParallelReadOptions& options = ParallelReadOptions(), ParallelReadStatistics* statistics = 0);
+
+} //namespace Lidar
+
+#endif /* PARALLELFILEREADER_H_ */
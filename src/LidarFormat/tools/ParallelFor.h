@@ -0,0 +1,114 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef PARALLELFOR_H_
+#define PARALLELFOR_H_
+
+#include <cstddef>
+#include <algorithm>
+
+#include "LidarFormat/tools/ThreadPool.h"
+
+
+namespace Lidar
+{
+
+namespace detail
+{
+
+//one sub-range of parallelFor
+template<typename TFunctor>
+struct _ParallelForTask : public _ThreadPoolTask
+{
+	_ParallelForTask(const std::size_t begin, const std::size_t end, const std::size_t rangeSize, const TFunctor& f):
+		begin_(begin), end_(end), rangeSize_(rangeSize), f_(f) {}
+
+	void operator()(const std::size_t chunk) const
+	{
+		TFunctor f(f_);
+		const std::size_t first = begin_ + chunk*rangeSize_;
+		f(first, std::min(first + rangeSize_, end_));
+	}
+
+	std::size_t begin_;
+	std::size_t end_;
+	std::size_t rangeSize_;
+	const TFunctor& f_;
+};
+
+} //namespace detail
+
+/**
+* Calls f(first, last) on consecutive sub-ranges of [begin, end), one sub-range per thread.
+* The sub-ranges run on the threads of ThreadPool::defaultPool(), the calling thread included.
+*
+* nbThreads==0 means one thread per core. Sub-ranges have at least minRangeSize elements,
+* so that small ranges are processed by the calling thread only.
+* f is copied for each sub-range and must not throw.
+*/
+template<typename TFunctor>
+void parallelFor(const std::size_t begin, const std::size_t end, TFunctor f, unsigned int nbThreads = 0, const std::size_t minRangeSize = 4096)
+{
+	if(begin >= end)
+		return;
+
+	if(nbThreads == 0)
+		nbThreads = defaultNbThreads();
+
+	const std::size_t nbElements = end - begin;
+	const std::size_t nbRanges = std::max<std::size_t>(1, std::min<std::size_t>(nbThreads, nbElements / std::max<std::size_t>(1, minRangeSize)));
+	const std::size_t rangeSize = (nbElements + nbRanges - 1) / nbRanges;
+
+	if(nbRanges == 1)
+	{
+		f(begin, end);
+		return;
+	}
+
+	const std::size_t nbChunks = (nbElements + rangeSize - 1) / rangeSize;
+	ThreadPool::defaultPool().run(nbChunks, detail::_ParallelForTask<TFunctor>(begin, end, rangeSize, f), static_cast<unsigned int>(nbChunks));
+}
+
+} //namespace Lidar
+
+#endif /* PARALLELFOR_H_ */
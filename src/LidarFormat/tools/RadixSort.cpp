@@ -0,0 +1,189 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#include <cassert>
+#include <algorithm>
+
+#include "LidarFormat/tools/ParallelFor.h"
+
+#include "RadixSort.h"
+
+
+namespace Lidar
+{
+
+namespace
+{
+
+const unsigned int nbBuckets = 256;
+const std::size_t minChunkSize = 65536;
+
+///Bits that differ between the keys of each chunk and the first key
+struct DiffMaskFunctor
+{
+	DiffMaskFunctor(const uint64* keys, const std::size_t chunkSize, const std::size_t size, std::vector<uint64>& masks):
+		keys_(keys), chunkSize_(chunkSize), size_(size), masks_(&masks) {}
+
+	void operator()(const std::size_t first, const std::size_t last) const
+	{
+		for(std::size_t chunk = first; chunk < last; ++chunk)
+		{
+			uint64 mask = 0;
+			const std::size_t end = std::min(size_, (chunk+1)*chunkSize_);
+			for(std::size_t i = chunk*chunkSize_; i < end; ++i)
+				mask |= keys_[i] ^ keys_[0];
+			(*masks_)[chunk] = mask;
+		}
+	}
+
+	const uint64* keys_;
+	std::size_t chunkSize_, size_;
+	std::vector<uint64>* masks_;
+};
+
+struct HistogramFunctor
+{
+	HistogramFunctor(const uint64* keys, const std::size_t chunkSize, const std::size_t size, const unsigned int shift, std::vector<std::size_t>& counts):
+		keys_(keys), chunkSize_(chunkSize), size_(size), shift_(shift), counts_(&counts) {}
+
+	void operator()(const std::size_t first, const std::size_t last) const
+	{
+		for(std::size_t chunk = first; chunk < last; ++chunk)
+		{
+			std::size_t* count = &(*counts_)[chunk*nbBuckets];
+			std::fill(count, count + nbBuckets, 0);
+			const std::size_t end = std::min(size_, (chunk+1)*chunkSize_);
+			for(std::size_t i = chunk*chunkSize_; i < end; ++i)
+				++count[(keys_[i] >> shift_) & 0xFF];
+		}
+	}
+
+	const uint64* keys_;
+	std::size_t chunkSize_, size_;
+	unsigned int shift_;
+	std::vector<std::size_t>* counts_;
+};
+
+///Moves the elements of each chunk from its offsets (counts turned into positions)
+struct ScatterFunctor
+{
+	ScatterFunctor(const uint64* keys, const EchoIndexType* indices, uint64* newKeys, EchoIndexType* newIndices,
+			const std::size_t chunkSize, const std::size_t size, const unsigned int shift, std::vector<std::size_t>& offsets):
+		keys_(keys), indices_(indices), newKeys_(newKeys), newIndices_(newIndices), chunkSize_(chunkSize), size_(size), shift_(shift), offsets_(&offsets) {}
+
+	void operator()(const std::size_t first, const std::size_t last) const
+	{
+		for(std::size_t chunk = first; chunk < last; ++chunk)
+		{
+			std::size_t* offset = &(*offsets_)[chunk*nbBuckets];
+			const std::size_t end = std::min(size_, (chunk+1)*chunkSize_);
+			for(std::size_t i = chunk*chunkSize_; i < end; ++i)
+			{
+				const std::size_t position = offset[(keys_[i] >> shift_) & 0xFF]++;
+				newKeys_[position] = keys_[i];
+				newIndices_[position] = indices_[i];
+			}
+		}
+	}
+
+	const uint64* keys_;
+	const EchoIndexType* indices_;
+	uint64* newKeys_;
+	EchoIndexType* newIndices_;
+	std::size_t chunkSize_, size_;
+	unsigned int shift_;
+	std::vector<std::size_t>* offsets_;
+};
+
+} //namespace
+
+
+void radixSort(std::vector<uint64>& keys, std::vector<EchoIndexType>& indices, const unsigned int nbThreads)
+{
+	assert(keys.size() == indices.size());
+
+	const std::size_t size = keys.size();
+	if(size < 2)
+		return;
+
+	//chunks fixed for all the passes: the order of the chunks keeps the sort stable
+	const std::size_t nbChunks = std::max<std::size_t>(1, std::min<std::size_t>(nbThreads == 0 ? defaultNbThreads() : nbThreads, size / minChunkSize));
+	const std::size_t chunkSize = (size + nbChunks - 1) / nbChunks;
+
+	std::vector<uint64> masks(nbChunks);
+	parallelFor(0, nbChunks, DiffMaskFunctor(&keys[0], chunkSize, size, masks), nbThreads, 1);
+	uint64 diffMask = 0;
+	for(std::size_t chunk = 0; chunk < nbChunks; ++chunk)
+		diffMask |= masks[chunk];
+
+	std::vector<uint64> newKeys(size);
+	std::vector<EchoIndexType> newIndices(size);
+	std::vector<std::size_t> counts(nbChunks*nbBuckets);
+
+	for(unsigned int shift = 0; shift < 64; shift += 8)
+	{
+		if(((diffMask >> shift) & 0xFF) == 0)
+			continue;
+
+		parallelFor(0, nbChunks, HistogramFunctor(&keys[0], chunkSize, size, shift, counts), nbThreads, 1);
+
+		//position of the first element of (bucket, chunk): buckets first, then chunks
+		std::size_t position = 0;
+		for(unsigned int bucket = 0; bucket < nbBuckets; ++bucket)
+		{
+			for(std::size_t chunk = 0; chunk < nbChunks; ++chunk)
+			{
+				const std::size_t count = counts[chunk*nbBuckets + bucket];
+				counts[chunk*nbBuckets + bucket] = position;
+				position += count;
+			}
+		}
+
+		parallelFor(0, nbChunks, ScatterFunctor(&keys[0], &indices[0], &newKeys[0], &newIndices[0], chunkSize, size, shift, counts), nbThreads, 1);
+
+		keys.swap(newKeys);
+		indices.swap(newIndices);
+	}
+}
+
+} //namespace Lidar
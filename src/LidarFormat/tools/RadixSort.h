@@ -0,0 +1,93 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef RADIXSORT_H_
+#define RADIXSORT_H_
+
+#include <vector>
+#include <cstring>
+
+#include "LidarFormat/LidarDataFormatTypes.h"
+
+
+namespace Lidar
+{
+
+///Unsigned keys in the same order as the values (for radixSort)
+inline uint64 radixKey(const uint8 value) { return value; }
+inline uint64 radixKey(const uint16 value) { return value; }
+inline uint64 radixKey(const uint32 value) { return value; }
+inline uint64 radixKey(const uint64 value) { return value; }
+
+//signés : le bit de signe est inversé
+inline uint64 radixKey(const int8 value) { return static_cast<uint8>(value) ^ 0x80u; }
+inline uint64 radixKey(const int16 value) { return static_cast<uint16>(value) ^ 0x8000u; }
+inline uint64 radixKey(const int32 value) { return static_cast<uint32>(value) ^ 0x80000000u; }
+inline uint64 radixKey(const int64 value) { return static_cast<uint64>(value) ^ (static_cast<uint64>(1) << 63); }
+
+//flottants : les négatifs sont inversés, le bit de signe des positifs est mis à 1
+inline uint64 radixKey(const float32 value)
+{
+	uint32 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+inline uint64 radixKey(const float64 value)
+{
+	const uint64 signBit = static_cast<uint64>(1) << 63;
+	uint64 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return (bits & signBit) ? ~bits : (bits | signBit);
+}
+
+/**
+* Sorts keys and applies the same permutation to indices (stable LSD radix sort, 8 bits per pass).
+* Passes on bytes that are the same for every key are skipped : small integer types cost 1 or 2 passes.
+* The histograms and the moves of each pass are split between nbThreads threads (0 : one per core).
+*/
+void radixSort(std::vector<uint64>& keys, std::vector<EchoIndexType>& indices, const unsigned int nbThreads = 1);
+
+} //namespace Lidar
+
+#endif /* RADIXSORT_H_ */
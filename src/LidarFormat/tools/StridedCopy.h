@@ -0,0 +1,122 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef STRIDEDCOPY_H_
+#define STRIDEDCOPY_H_
+
+#include <cstddef>
+#include <cstring>
+#include <climits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+namespace Lidar
+{
+
+/**
+* Copies between the strided values of an attribute (one every stride bytes, as in the echoes of a container)
+* and unit-stride arrays, for the kernels that work on blocks of echoes.
+*
+* The values are copied with memcpy, so neither side needs to be aligned. When the library is built with
+* AVX2 (CMake option ENABLE_AVX2), float and double are read with gather instructions (AVX2 has no scatter: the writes stay scalar).
+*/
+
+///destination[k] = value at source + k*stride, for k in [0, n)
+template<typename T>
+inline void gatherStrided(const char* source, const std::size_t stride, const std::size_t n, T* destination)
+{
+	for(std::size_t k = 0; k < n; ++k, source += stride)
+		std::memcpy(destination + k, source, sizeof(T));
+}
+
+///value at destination + k*stride = source[k], for k in [0, n)
+template<typename T>
+inline void scatterStrided(const T* source, const std::size_t n, char* destination, const std::size_t stride)
+{
+	for(std::size_t k = 0; k < n; ++k, destination += stride)
+		std::memcpy(destination, source + k, sizeof(T));
+}
+
+#if defined(__AVX2__)
+template<>
+inline void gatherStrided<double>(const char* source, const std::size_t stride, const std::size_t n, double* destination)
+{
+	std::size_t k = 0;
+	//byte offsets of 4 consecutive values, relative to the current position
+	if(stride <= INT_MAX/4)
+	{
+		const int s = static_cast<int>(stride);
+		const __m128i offsets = _mm_setr_epi32(0, s, 2*s, 3*s);
+		//masked gather with a zero source : the unmasked one leaves its source register uninitialized (-Wmaybe-uninitialized)
+		const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+		for(; k + 4 <= n; k += 4, source += 4*stride)
+			_mm256_storeu_pd(destination + k, _mm256_mask_i32gather_pd(_mm256_setzero_pd(), reinterpret_cast<const double*>(source), offsets, all, 1));
+	}
+	//last values one by one
+	for(; k < n; ++k, source += stride)
+		std::memcpy(destination + k, source, sizeof(double));
+}
+
+template<>
+inline void gatherStrided<float>(const char* source, const std::size_t stride, const std::size_t n, float* destination)
+{
+	std::size_t k = 0;
+	if(stride <= INT_MAX/8)
+	{
+		const int s = static_cast<int>(stride);
+		const __m256i offsets = _mm256_setr_epi32(0, s, 2*s, 3*s, 4*s, 5*s, 6*s, 7*s);
+		const __m256 all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for(; k + 8 <= n; k += 8, source += 8*stride)
+			_mm256_storeu_ps(destination + k, _mm256_mask_i32gather_ps(_mm256_setzero_ps(), reinterpret_cast<const float*>(source), offsets, all, 1));
+	}
+	for(; k < n; ++k, source += stride)
+		std::memcpy(destination + k, source, sizeof(float));
+}
+#endif
+
+} //namespace Lidar
+
+#endif /* STRIDEDCOPY_H_ */
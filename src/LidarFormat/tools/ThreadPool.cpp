@@ -0,0 +1,219 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#include <boost/bind.hpp>
+#include <boost/thread/once.hpp>
+#include <boost/thread/locks.hpp>
+
+#include "LidarFormat/tools/ThreadPool.h"
+
+
+namespace Lidar
+{
+
+namespace
+{
+
+ThreadPool* defaultPoolPtr = 0;
+boost::once_flag defaultPoolFlag = BOOST_ONCE_INIT;
+
+void createDefaultPool()
+{
+	//destroyed at exit, which joins its threads
+	static ThreadPool pool;
+	defaultPoolPtr = &pool;
+}
+
+} //namespace
+
+ThreadPool& ThreadPool::defaultPool()
+{
+	boost::call_once(createDefaultPool, defaultPoolFlag);
+	return *defaultPoolPtr;
+}
+
+ThreadPool::ThreadPool():
+	m_nbWorkers(0), m_shares(1, boost::shared_ptr<Share>(new Share)), m_task(0), m_nbParticipants(0), m_nbRunning(0), m_generation(0), m_stop(false)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		boost::lock_guard<boost::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wakeUp.notify_all();
+	m_threads.join_all();
+}
+
+std::size_t ThreadPool::nbWorkers() const
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+	return m_nbWorkers;
+}
+
+void ThreadPool::addWorkers(const std::size_t nbWorkers)
+{
+	//no job is running : m_shares and m_generation are stable
+	while(m_shares.size() < nbWorkers + 1)
+		m_shares.push_back(boost::shared_ptr<Share>(new Share));
+
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+	for( ; m_nbWorkers < nbWorkers; ++m_nbWorkers)
+		m_threads.create_thread(boost::bind(&ThreadPool::workerLoop, this, static_cast<unsigned int>(m_nbWorkers + 1), m_generation));
+}
+
+void ThreadPool::run(const std::size_t nbChunks, const detail::_ThreadPoolTask& task, unsigned int nbThreads)
+{
+	if(nbThreads == 0)
+		nbThreads = defaultNbThreads();
+	nbThreads = static_cast<unsigned int>(std::min<std::size_t>(nbThreads, nbChunks));
+
+	boost::unique_lock<boost::mutex> jobLock(m_jobMutex, boost::try_to_lock);
+	if(nbThreads <= 1 || !jobLock.owns_lock())
+	{
+		for(std::size_t chunk = 0; chunk < nbChunks; ++chunk)
+			task(chunk);
+		return;
+	}
+
+	addWorkers(nbThreads - 1);
+
+	for(unsigned int id = 0; id < nbThreads; ++id)
+	{
+		Share& share = *m_shares[id];
+		boost::lock_guard<boost::mutex> lock(share.mutex);
+		share.next = nbChunks*id / nbThreads;
+		share.end = nbChunks*(id + 1) / nbThreads;
+	}
+
+	{
+		boost::lock_guard<boost::mutex> lock(m_mutex);
+		m_task = &task;
+		m_nbParticipants = nbThreads;
+		m_nbRunning = nbThreads;
+		++m_generation;
+	}
+	m_wakeUp.notify_all();
+
+	work(0);
+
+	boost::unique_lock<boost::mutex> lock(m_mutex);
+	while(m_nbRunning > 0)
+		m_done.wait(lock);
+	m_task = 0;
+}
+
+void ThreadPool::workerLoop(const unsigned int id, std::size_t generation)
+{
+	for(;;)
+	{
+		{
+			boost::unique_lock<boost::mutex> lock(m_mutex);
+			while(!m_stop && m_generation == generation)
+				m_wakeUp.wait(lock);
+			if(m_stop)
+				return;
+
+			generation = m_generation;
+			if(id >= m_nbParticipants)
+				continue;
+		}
+
+		work(id);
+	}
+}
+
+void ThreadPool::work(const unsigned int id)
+{
+	std::size_t chunk;
+	while(pop(id, chunk) || steal(id, chunk))
+		(*m_task)(chunk);
+
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+	if(--m_nbRunning == 0)
+		m_done.notify_all();
+}
+
+bool ThreadPool::pop(const unsigned int id, std::size_t& chunk)
+{
+	Share& share = *m_shares[id];
+	boost::lock_guard<boost::mutex> lock(share.mutex);
+	if(share.next == share.end)
+		return false;
+
+	chunk = share.next++;
+	return true;
+}
+
+bool ThreadPool::steal(const unsigned int id, std::size_t& chunk)
+{
+	for(unsigned int k = 1; k < m_nbParticipants; ++k)
+	{
+		//second half of the chunks left to the victim
+		std::size_t first, last;
+		{
+			Share& victim = *m_shares[(id + k) % m_nbParticipants];
+			boost::lock_guard<boost::mutex> lock(victim.mutex);
+			const std::size_t nbLeft = victim.end - victim.next;
+			if(nbLeft == 0)
+				continue;
+
+			last = victim.end;
+			first = last - (nbLeft + 1)/2;
+			victim.end = first;
+		}
+
+		Share& share = *m_shares[id];
+		boost::lock_guard<boost::mutex> lock(share.mutex);
+		share.next = first + 1;
+		share.end = last;
+		chunk = first;
+		return true;
+	}
+
+	return false;
+}
+
+} //namespace Lidar
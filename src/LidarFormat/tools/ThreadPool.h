@@ -0,0 +1,140 @@
+/***********************************************************************
+
+This file is part of the LidarFormat project source files.
+
+LidarFormat is an open source library for efficiently handling 3D point 
+clouds with a variable number of attributes at runtime. 
+
+
+Homepage: 
+
+	http://code.google.com/p/lidarformat
+	
+Copyright:
+	
+	Institut Geographique National & CEMAGREF (2009)
+
+Author: 
+
+	Adrien Chauve
+	
+Contributors:
+
+	Nicolas David, Olivier Tournaire
+	
+	
+
+    LidarFormat is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LidarFormat is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public 
+    License along with LidarFormat.  If not, see <http://www.gnu.org/licenses/>.
+ 
+***********************************************************************/
+
+
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+
+namespace Lidar
+{
+
+///Number of threads to use for nbThreads==0 (at least 1)
+inline unsigned int defaultNbThreads()
+{
+	return std::max(1u, boost::thread::hardware_concurrency());
+}
+
+namespace detail
+{
+
+//work of a ThreadPool job, called once for each chunk
+struct _ThreadPoolTask
+{
+	virtual ~_ThreadPoolTask() {}
+	virtual void operator()(const std::size_t chunk) const = 0;
+};
+
+} //namespace detail
+
+/**
+* @brief Threads shared by the parallel loops of the library (parallelFor, parallel_for_each...).
+*
+* A job is a number of chunks. Each thread taking part in it starts with a contiguous share of the chunks,
+* then steals half of the chunks left to another thread: uneven chunks are balanced without a global queue.
+* The calling thread takes part in the job. The threads are created on demand and wait between jobs.
+*
+* One job runs at a time : a job submitted while another one is running (from another thread, or from inside
+* a chunk) is run by the calling thread alone.
+*
+*/
+class ThreadPool : private boost::noncopyable
+{
+	public:
+		ThreadPool();
+		~ThreadPool();
+
+		///Calls task(chunk) for each chunk of [0, nbChunks) on nbThreads threads (0 : one per core), the calling thread included
+		///  returns once every chunk is done ; task must not throw
+		void run(const std::size_t nbChunks, const detail::_ThreadPoolTask& task, unsigned int nbThreads = 0);
+
+		///Number of threads created so far (the calling threads excluded)
+		std::size_t nbWorkers() const;
+
+		///Pool used by the parallel functions of the library
+		static ThreadPool& defaultPool();
+
+	private:
+		//chunks [next, end) left to one thread of the job
+		struct Share
+		{
+			boost::mutex mutex;
+			std::size_t next;
+			std::size_t end;
+		};
+
+		void addWorkers(const std::size_t nbWorkers);
+		void workerLoop(const unsigned int id, std::size_t generation);
+		//runs the chunks of the thread id, then the stolen ones
+		void work(const unsigned int id);
+		bool pop(const unsigned int id, std::size_t& chunk);
+		bool steal(const unsigned int id, std::size_t& chunk);
+
+		boost::mutex m_jobMutex; //held by the thread that submitted the current job
+		mutable boost::mutex m_mutex;
+		boost::condition_variable m_wakeUp;
+		boost::condition_variable m_done;
+
+		boost::thread_group m_threads;
+		std::size_t m_nbWorkers;
+		std::vector<boost::shared_ptr<Share> > m_shares; //one per thread of the job (0 : calling thread)
+
+		const detail::_ThreadPoolTask* m_task;
+		unsigned int m_nbParticipants;
+		unsigned int m_nbRunning;
+		std::size_t m_generation; //incremented for each job
+		bool m_stop;
+};
+
+} //namespace Lidar
+
+#endif /* THREADPOOL_H_ */
@@ -41,6 +41,7 @@ Contributors:
 
 
 #include <iostream>
+#include <cstring>
 #include <boost/filesystem.hpp>
 
 #include <boost/progress.hpp>
@@ -52,12 +53,20 @@ Contributors:
 #include "LidarFormat/LidarDataViewElement.hpp"
 #include "LidarFormat/LidarDataView.hpp"
 
+void checkIndexViewPerformance();
 
-int main()
+//03_ex_indexView --benchmark : timings of the index views (permutation/prefetch iterators, sorted indices) instead of the example
+int main(int argc, char** argv)
 {
 	using namespace Lidar;
 	using namespace std;
 
+	if(argc > 1 && std::strcmp(argv[1], "--benchmark") == 0)
+	{
+		checkIndexViewPerformance();
+		return 0;
+	}
+
 
 
 	/**** Load data in a container ****/
@@ -169,7 +178,7 @@ int main()
 	//****************************************************************************************
 	std::cout<<std::endl<<" debut index view"<<std::endl;
 	std::cout<<" \t index 2 4 6 8 "<<std::endl;
-	boost::shared_ptr<std::vector<int> > index_ptr(new std::vector<int> );
+	boost::shared_ptr<std::vector<EchoIndexType> > index_ptr(new std::vector<EchoIndexType> );
 	index_ptr->push_back(2);
 	index_ptr->push_back(4);
 	index_ptr->push_back(6);
@@ -269,3 +278,81 @@ void checkPerformance()
 
 }
 
+
+
+//sums x+y+z over the echoes of [itbegin, ite)
+template<typename Iterator>
+double sumXYZ(Iterator itbegin, const Iterator ite)
+{
+	double sum = 0.;
+	for( ; itbegin != ite; ++itbegin)
+		sum += (*itbegin).template get<0>() + (*itbegin).template get<1>() + (*itbegin).template get<2>();
+	return sum;
+}
+
+void checkIndexViewPerformance()
+{
+	boost::shared_ptr<LidarDataContainer> lidarContainer(new LidarDataContainer() );
+	lidarContainer->addAttribute("x", LidarDataType::float64);
+	lidarContainer->addAttribute("y", LidarDataType::float64);
+	lidarContainer->addAttribute("z", LidarDataType::float64);
+	lidarContainer->addAttribute("intensity", LidarDataType::float32);
+	const std::size_t taille = 20000000;
+	lidarContainer->resize(taille);
+
+	const unsigned int echo_stride = lidarContainer->pointSize();
+	const unsigned int x_offset = lidarContainer->getDecalage("x");
+	const unsigned int y_offset = lidarContainer->getDecalage("y");
+	const unsigned int z_offset = lidarContainer->getDecalage("z");
+
+	//random : indices spread over the whole container
+	//clustered : neighbourhoods of 64 consecutive echoes, at random places
+	const std::size_t nbIndices = 4000000;
+	boost::shared_ptr<std::vector<EchoIndexType> > random_index(new std::vector<EchoIndexType>(nbIndices));
+	boost::shared_ptr<std::vector<EchoIndexType> > clustered_index(new std::vector<EchoIndexType>(nbIndices));
+	boost::uint64_t seed = 12345;
+	for(std::size_t i = 0; i < nbIndices; ++i)
+	{
+		seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+		(*random_index)[i] = static_cast<EchoIndexType>((seed >> 16) % taille);
+		if(i%64 == 0)
+			(*clustered_index)[i] = static_cast<EchoIndexType>((seed >> 16) % (taille - 64));
+		else
+			(*clustered_index)[i] = (*clustered_index)[i-1] + 1;
+	}
+
+	typedef LidarDataAttProxyIndexView<double,3> index_view_type;
+	const char* names[2] = {"random", "clustered"};
+	boost::shared_ptr<std::vector<EchoIndexType> > indices[2] = {random_index, clustered_index};
+
+	for(int k = 0; k < 2; ++k)
+	{
+		index_view_type view(lidarContainer, indices[k], echo_stride, x_offset, y_offset, z_offset);
+
+		{
+			std::cout << "\n\n" << names[k] << " indices, permutation iterator:\n";
+			boost::progress_timer t;
+			std::cout << sumXYZ(view.begin(), view.end()) << "\n";
+		}
+		{
+			std::cout << "\n\n" << names[k] << " indices, prefetch iterator:\n";
+			boost::progress_timer t;
+			std::cout << sumXYZ(view.prefetch_begin(), view.prefetch_end()) << "\n";
+		}
+		{
+			std::cout << "\n\n" << names[k] << " indices, sort_indices:\n";
+			boost::progress_timer t;
+			view.sort_indices();
+		}
+		{
+			std::cout << "\n\n" << names[k] << " indices, sorted, permutation iterator:\n";
+			boost::progress_timer t;
+			std::cout << sumXYZ(view.begin(), view.end()) << "\n";
+		}
+		{
+			std::cout << "\n\n" << names[k] << " indices, sorted, prefetch iterator:\n";
+			boost::progress_timer t;
+			std::cout << sumXYZ(view.prefetch_begin(), view.prefetch_end()) << "\n";
+		}
+	}
+}
@@ -44,10 +44,27 @@ Contributors:
 #define BOOST_TEST_MODULE LidarFormatUnitTests
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <fstream>
+#include <functional>
+
+#include <boost/filesystem.hpp>
+
 #include "config_data_test.h"
 
 #include "LidarFormat/LidarDataContainer.h"
+#include "LidarFormat/LidarColumnarDataContainer.h"
+#include "LidarFormat/LidarSegmentedDataContainer.h"
+#include "LidarFormat/LidarDataContainerT.h"
+#include "LidarFormat/LidarDataSlice.h"
+#include "LidarFormat/LidarPipeline.h"
+#include "LidarFormat/LidarDataViewElement.hpp"
+#include "LidarFormat/LidarDataView.hpp"
 #include "LidarFormat/LidarFile.h"
+#include "LidarFormat/apply.h"
+#include "LidarFormat/geometry/LidarSpatialReordering.h"
+#include "LidarFormat/tools/ParallelFor.h"
+#include "LidarFormat/tools/ParallelAlgorithms.h"
 
 using namespace Lidar;
 using namespace std;
@@ -67,6 +84,25 @@ const string lidarFileName(string(PATH_LIDAR_TEST_DATA) + "/testAscii.xml");
 const double firstX = 919351.96, firstY = 1914105.38, firstZ = 1075.35;
 const double lastX = 919360.56, lastY = 1914108.38, lastZ = 1079.2;
 
+//dossier temporaire unique pour les fichiers écrits par un test, supprimé à la fin du test
+struct TemporaryDirectory
+{
+	TemporaryDirectory(): path(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path())
+	{
+		boost::filesystem::create_directories(path);
+	}
+
+	~TemporaryDirectory()
+	{
+		boost::system::error_code error;
+		boost::filesystem::remove_all(path, error);
+	}
+
+	string file(const string& fileName) const { return (path / fileName).string(); }
+
+	boost::filesystem::path path;
+};
+
 
 
 BOOST_AUTO_TEST_CASE( LidarIteratorEcho_tests )
@@ -151,4 +187,1357 @@ BOOST_AUTO_TEST_CASE( LidarIteratorAttribute_tests )
 
 
 
+BOOST_AUTO_TEST_CASE( LidarFile_mapData_tests )
+{
+	const TemporaryDirectory directory;
+	LidarFile file(lidarFileName);
+	LidarDataContainer lidarContainer;
+	file.loadData(lidarContainer);
+
+	const string lidarFileNameBinary(directory.file("testMapped.xml"));
+	LidarFile::save(lidarContainer, lidarFileNameBinary);
+
+	//read-only mapping: same content, shared by copies
+	{
+		LidarFile fileBinary(lidarFileNameBinary);
+		LidarDataContainer mappedContainer;
+		fileBinary.loadData(mappedContainer, mapReadOnly);
+
+		BOOST_CHECK(mappedContainer.isMapped());
+		BOOST_CHECK_EQUAL(mappedContainer.size(), lidarContainer.size());
+		BOOST_CHECK(std::equal(lidarContainer.rawData(), lidarContainer.rawData() + lidarContainer.size()*lidarContainer.pointSize(), mappedContainer.rawData()));
+
+		LidarDataContainer copiedContainer(mappedContainer);
+		BOOST_CHECK_EQUAL(TPoint3D<double>(*(copiedContainer.endXYZ<double>()-1)), TPoint3D<double>(lastX, lastY, lastZ));
+
+		//modifying a read-only mapping first copies it in memory
+		copiedContainer.erase(0);
+		BOOST_CHECK(!copiedContainer.isMapped());
+		BOOST_CHECK_EQUAL(copiedContainer.size(), lidarContainer.size()-1);
+		BOOST_CHECK_EQUAL(*mappedContainer.beginAttribute<double>("x"), firstX);
+	}
+
+	//copy-on-write mapping: modifications are not written in the file
+	{
+		LidarFile fileBinary(lidarFileNameBinary);
+		LidarDataContainer mappedContainer;
+		fileBinary.loadData(mappedContainer, mapCopyOnWrite);
+
+		*mappedContainer.beginAttribute<double>("x") = 0.;
+		BOOST_CHECK_EQUAL(*mappedContainer.beginAttribute<double>("x"), 0.);
+
+		mappedContainer.push_back(mappedContainer.rawData(0));
+		BOOST_CHECK(!mappedContainer.isMapped());
+		BOOST_CHECK_EQUAL(mappedContainer.size(), lidarContainer.size()+1);
+
+		LidarDataContainer reloadedContainer;
+		LidarFile(lidarFileNameBinary).loadData(reloadedContainer, mapReadOnly);
+		BOOST_CHECK_EQUAL(*reloadedContainer.beginAttribute<double>("x"), firstX);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( readFileParallel_tests )
+{
+	//fichier de plusieurs chunks, dont le dernier est incomplet
+	const TemporaryDirectory directory;
+	const string fileName(directory.file("testParallelRead.bin"));
+	std::vector<char> content(25*4096 + 100);
+	for(std::size_t i = 0; i < content.size(); ++i)
+		content[i] = static_cast<char>(i*7 + i/4096);
+	{
+		std::ofstream fileOut(fileName.c_str(), std::ios::binary);
+		fileOut.write(&content[0], content.size());
+	}
+
+	const EnumReadCacheMode modes[] = {readCached, readSequential, readNoReuse, readDirect};
+	for(unsigned int m = 0; m < 4; ++m)
+	{
+		ParallelReadOptions options;
+		options.chunkSize = 4000; //arrondi à 4096
+		options.nbThreads = 3;
+		options.cacheMode = modes[m];
+
+		//on demande plus que la taille du fichier
+		std::vector<char> data(content.size() + 5000, 0);
+		ParallelReadStatistics statistics;
+		BOOST_CHECK_EQUAL(readFileParallel(fileName, &data[1], data.size() - 1, options, &statistics), content.size());
+		BOOST_CHECK(std::equal(content.begin(), content.end(), data.begin() + 1));
+		BOOST_CHECK_EQUAL(statistics.nbBytes, content.size());
+		BOOST_CHECK_EQUAL(statistics.nbChunks, 27u);
+		BOOST_CHECK_EQUAL(statistics.nbThreads, 3u);
+	}
+
+	BOOST_CHECK_THROW(readFileParallel(fileName + ".absent", &content[0], content.size()), std::logic_error);
+
+	//chargement du format binaire
+	LidarDataContainer lidarContainer;
+	LidarFile(lidarFileName).loadData(lidarContainer);
+	const string lidarFileNameBinary(directory.file("testParallelRead.xml"));
+	LidarFile::save(lidarContainer, lidarFileNameBinary);
+
+	LidarFile fileBinary(lidarFileNameBinary);
+	ParallelReadOptions options;
+	options.cacheMode = readDirect;
+	fileBinary.setReadOptions(options);
+	LidarDataContainer reloadedContainer;
+	fileBinary.loadData(reloadedContainer);
+	BOOST_CHECK_EQUAL(reloadedContainer.size(), lidarContainer.size());
+	BOOST_CHECK(std::equal(lidarContainer.rawData(), lidarContainer.rawData() + lidarContainer.size()*lidarContainer.pointSize(), reloadedContainer.rawData()));
+	BOOST_CHECK_EQUAL(fileBinary.getReadStatistics().nbBytes, lidarContainer.size()*lidarContainer.pointSize());
+	BOOST_CHECK_EQUAL(fileBinary.getReadStatistics().nbChunks, 1u);
+	BOOST_CHECK(!fileBinary.getReadStatistics().sizeMismatch);
+
+	//un écho de plus dans le binaire que dans le xml : signalé dans les statistiques
+	{
+		std::ofstream fileOut(fileBinary.getBinaryDataFileName().c_str(), std::ios::binary | std::ios::app);
+		fileOut.write(lidarContainer.rawData(), lidarContainer.pointSize());
+	}
+	fileBinary.loadData(reloadedContainer);
+	BOOST_CHECK(fileBinary.getReadStatistics().sizeMismatch);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( LidarColumnarDataContainer_tests )
+{
+	LidarFile file(lidarFileName);
+	LidarDataContainer lidarContainer;
+	file.loadData(lidarContainer);
+
+	boost::shared_ptr<LidarColumnarDataContainer> columnarContainer(new LidarColumnarDataContainer(lidarContainer));
+	BOOST_CHECK_EQUAL(columnarContainer->size(), lidarContainer.size());
+	BOOST_CHECK_EQUAL(columnarContainer->pointSize(), lidarContainer.pointSize());
+
+	//contiguous and aligned columns
+	const double* columnX = columnarContainer->column<double>("x");
+	BOOST_CHECK_EQUAL(reinterpret_cast<std::size_t>(columnX) % LidarDataBuffer::alignment, 0u);
+	BOOST_CHECK_EQUAL(columnX[0], firstX);
+	BOOST_CHECK_EQUAL(columnX[columnarContainer->size()-1], lastX);
+	BOOST_CHECK(std::equal(lidarContainer.beginAttribute<double>("z"), lidarContainer.endAttribute<double>("z"), columnarContainer->beginAttribute<double>("z")));
+
+	LidarDataAttView<double, LidarColumnarDataContainer> viewY(columnarContainer, columnarContainer->getColumnOffset("y"), columnarContainer->getStride("y"));
+	BOOST_CHECK_EQUAL(viewY.end() - viewY.begin(), static_cast<std::ptrdiff_t>(lidarContainer.size()));
+	BOOST_CHECK_EQUAL(*viewY.begin(), firstY);
+
+	//the columns keep their content when the container grows
+	columnarContainer->addAttribute("index", LidarDataType::uint32);
+	columnarContainer->resize(2*lidarContainer.size());
+	BOOST_CHECK_EQUAL(*(columnarContainer->endAttribute<double>("x")-1), 0.);
+	BOOST_CHECK_EQUAL(columnarContainer->column<double>("x")[lidarContainer.size()-1], lastX);
+	BOOST_CHECK_EQUAL(*columnarContainer->beginAttribute<unsigned int>("index"), 0u);
+
+	//round trip
+	columnarContainer->resize(lidarContainer.size());
+	LidarDataContainer interleavedContainer;
+	columnarContainer->toInterleaved(interleavedContainer);
+	BOOST_CHECK_EQUAL(interleavedContainer.pointSize(), lidarContainer.pointSize() + 4);
+	BOOST_CHECK(std::equal(lidarContainer.beginAttribute<double>("y"), lidarContainer.endAttribute<double>("y"), interleavedContainer.beginAttribute<double>("y")));
+	BOOST_CHECK_THROW(columnarContainer->toInterleaved(lidarContainer), std::logic_error);
+
+	//même taille d'écho, mais attribut absent ou d'un autre type : rien n'est écrit
+	LidarColumnarDataContainer smallContainer;
+	smallContainer.addAttribute("x", LidarDataType::float64);
+	smallContainer.addAttribute("c", LidarDataType::uint32);
+	smallContainer.resize(3);
+	LidarDataContainer missingName;
+	missingName.addAttribute("a", LidarDataType::float64);
+	missingName.addAttribute("c", LidarDataType::uint32);
+	BOOST_CHECK_THROW(smallContainer.toInterleaved(missingName), std::logic_error);
+	BOOST_CHECK(missingName.empty());
+	LidarDataContainer otherType;
+	otherType.addAttribute("x", LidarDataType::int64);
+	otherType.addAttribute("c", LidarDataType::uint32);
+	BOOST_CHECK_THROW(smallContainer.toInterleaved(otherType), std::logic_error);
+	BOOST_CHECK(otherType.empty());
+}
+
+
+
+BOOST_AUTO_TEST_CASE( LidarDataContainer_attributes_tests )
+{
+	LidarFile file(lidarFileName);
+	LidarDataContainer lidarContainer;
+	file.loadData(lidarContainer);
+	const LidarDataContainer originalContainer(lidarContainer);
+
+	//ajout sur un conteneur rempli
+	BOOST_CHECK(lidarContainer.addAttribute("height_above_ground", LidarDataType::float32));
+	BOOST_CHECK(!lidarContainer.addAttribute("height_above_ground", LidarDataType::float32));
+	BOOST_CHECK_EQUAL(lidarContainer.size(), originalContainer.size());
+	BOOST_CHECK_EQUAL(lidarContainer.pointSize(), originalContainer.pointSize() + 4);
+	BOOST_CHECK(std::equal(originalContainer.beginAttribute<double>("z"), originalContainer.endAttribute<double>("z"), lidarContainer.beginAttribute<double>("z")));
+	BOOST_CHECK_EQUAL(*(lidarContainer.endAttribute<float>("height_above_ground")-1), 0.f);
+	*lidarContainer.beginAttribute<float>("height_above_ground") = 12.5f;
+
+	//suppression de x et y : les attributs suivants sont tassés
+	std::vector<std::string> deletedAttributes;
+	deletedAttributes.push_back("x");
+	deletedAttributes.push_back("y");
+	lidarContainer.delAttributes(deletedAttributes);
+	BOOST_CHECK(!lidarContainer.checkAttributeIsPresent("x"));
+	BOOST_CHECK(!lidarContainer.delAttribute("y"));
+	BOOST_CHECK_EQUAL(lidarContainer.getDecalage("z"), originalContainer.getDecalage("z") - 2*sizeof(double));
+	BOOST_CHECK(std::equal(originalContainer.beginAttribute<double>("z"), originalContainer.endAttribute<double>("z"), lidarContainer.beginAttribute<double>("z")));
+	BOOST_CHECK_EQUAL(*lidarContainer.beginAttribute<float>("height_above_ground"), 12.5f);
+
+	//plusieurs attributs, en parallèle
+	LidarDataContainer bigContainer;
+	bigContainer.addAttribute("x", LidarDataType::float64);
+	bigContainer.addAttribute("classification", LidarDataType::uint8);
+	bigContainer.resize(100000);
+	for(LidarIteratorAttribute<double> it = bigContainer.beginAttribute<double>("x"); it != bigContainer.endAttribute<double>("x"); ++it)
+		*it = it - bigContainer.beginAttribute<double>("x");
+
+	LidarDataContainer::AttributeListType newAttributes;
+	newAttributes.push_back(LidarDataContainer::AttributeListType::value_type("normal_z", LidarDataType::float32));
+	newAttributes.push_back(LidarDataContainer::AttributeListType::value_type("index", LidarDataType::uint32));
+	bigContainer.addAttributes(newAttributes, 4);
+	bigContainer.delAttribute("classification");
+	BOOST_CHECK_EQUAL(bigContainer.pointSize(), 16u);
+	BOOST_CHECK_EQUAL(*(bigContainer.endAttribute<double>("x")-1), 99999.);
+	BOOST_CHECK_EQUAL(*(bigContainer.endAttribute<unsigned int>("index")-1), 0u);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( LidarDataAllocator_tests )
+{
+	LidarFile file(lidarFileName);
+	LidarDataContainer lidarContainer;
+	file.loadData(lidarContainer);
+	BOOST_CHECK_EQUAL(reinterpret_cast<std::size_t>(lidarContainer.rawData()) % LidarDataAllocator::alignment, 0u);
+
+	//les blocs de plus de 4 Mo passent par des huge pages
+	lidarContainer.setAllocator(boost::shared_ptr<LidarDataAllocator>(new HugePageAllocator(false, 4*1024*1024)));
+	BOOST_CHECK_EQUAL(*lidarContainer.beginAttribute<double>("x"), firstX);
+
+	const std::size_t nbEchos = 8*1024*1024 / lidarContainer.pointSize();
+	lidarContainer.resize(nbEchos);
+	BOOST_CHECK_EQUAL(reinterpret_cast<std::size_t>(lidarContainer.rawData()) % LidarDataAllocator::alignment, 0u);
+	BOOST_CHECK_EQUAL(*lidarContainer.beginAttribute<double>("x"), firstX);
+	BOOST_CHECK_EQUAL(*(lidarContainer.endAttribute<double>("z")-1), 0.);
+
+	//the allocator follows the copies
+	LidarDataContainer copiedContainer(lidarContainer);
+	BOOST_CHECK(copiedContainer.getAllocator() == lidarContainer.getAllocator());
+	copiedContainer.resizeUninitialized(2*nbEchos);
+	BOOST_CHECK_EQUAL(copiedContainer.size(), 2*nbEchos);
+	BOOST_CHECK_EQUAL(*(copiedContainer.beginAttribute<double>("z")+nbEchos-1), 0.);
+
+	lidarContainer.setAllocator(LidarDataAllocator::defaultAllocator());
+	BOOST_CHECK_EQUAL(*(lidarContainer.endAttribute<double>("x")-nbEchos), firstX);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( LidarSegmentedDataContainer_tests )
+{
+	LidarFile file(lidarFileName);
+	LidarDataContainer lidarContainer;
+	file.loadData(lidarContainer);
+
+	//blocs de 4 échos : les 10 échos du fichier remplissent 3 blocs
+	LidarSegmentedDataContainer segmentedContainer(4);
+	segmentedContainer.setAttributes(lidarContainer.getAttributeMap());
+	BOOST_CHECK_EQUAL(segmentedContainer.pointSize(), lidarContainer.pointSize());
+
+	segmentedContainer.append(lidarContainer);
+	BOOST_CHECK_EQUAL(segmentedContainer.size(), lidarContainer.size());
+	BOOST_CHECK_EQUAL(segmentedContainer.getNbBlocks(), 3u);
+	BOOST_CHECK_EQUAL(segmentedContainer.getBlockSize(2), 2u);
+
+	//appending does not move the echoes already stored
+	const char* firstBlock = segmentedContainer.getBlock(0);
+	segmentedContainer.push_back(lidarContainer[0]);
+	segmentedContainer.append(segmentedContainer);
+	BOOST_CHECK_EQUAL(static_cast<const void*>(segmentedContainer.getBlock(0)), static_cast<const void*>(firstBlock));
+	BOOST_CHECK_EQUAL(segmentedContainer.size(), 2*(lidarContainer.size()+1));
+
+	//iterators across the blocks
+	const LidarSegmentedDataContainer& constSegmentedContainer = segmentedContainer;
+	LidarSegmentedDataContainer::const_iterator it = constSegmentedContainer.begin();
+	BOOST_CHECK_EQUAL(constSegmentedContainer.end() - it, static_cast<std::ptrdiff_t>(segmentedContainer.size()));
+	BOOST_CHECK_EQUAL((it+lidarContainer.size()-1).value<double>("x"), lastX);
+	BOOST_CHECK_EQUAL((it+lidarContainer.size()).value<double>("x"), firstX);
+	BOOST_CHECK(*(it+lidarContainer.size()+1) == lidarContainer[0]);
+
+	unsigned int nbEchos = 0;
+	for(LidarSegmentedDataContainer::iterator itEcho = segmentedContainer.begin(); itEcho != segmentedContainer.end(); ++itEcho, ++nbEchos)
+		itEcho.value<double>("z") += 1.;
+	BOOST_CHECK_EQUAL(nbEchos, segmentedContainer.size());
+
+	LidarDataContainer contiguousContainer;
+	segmentedContainer.copyTo(contiguousContainer);
+	BOOST_CHECK_EQUAL(contiguousContainer.size(), segmentedContainer.size());
+	BOOST_CHECK_EQUAL(*(contiguousContainer.endAttribute<double>("z")-1), firstZ + 1.);
+
+	//même taille d'écho, mais attributs dans un autre ordre : copie octet par octet impossible
+	LidarDataContainer otherLayoutContainer;
+	std::vector<AttributeMapType::const_iterator> attributes;
+	for(AttributeMapType::const_iterator itAttribute = lidarContainer.getAttributeMap().begin(); itAttribute != lidarContainer.getAttributeMap().end(); ++itAttribute)
+		attributes.push_back(itAttribute);
+	for(std::vector<AttributeMapType::const_iterator>::reverse_iterator itAttribute = attributes.rbegin(); itAttribute != attributes.rend(); ++itAttribute)
+		otherLayoutContainer.addAttribute((*itAttribute)->first, (*itAttribute)->second.type);
+	BOOST_CHECK_EQUAL(otherLayoutContainer.pointSize(), segmentedContainer.pointSize());
+	BOOST_CHECK_THROW(segmentedContainer.copyTo(otherLayoutContainer), std::logic_error);
+	BOOST_CHECK_EQUAL(otherLayoutContainer.size(), 0u);
+
+	segmentedContainer.resize(3);
+	BOOST_CHECK_EQUAL(segmentedContainer.getNbBlocks(), 1u);
+	segmentedContainer.resize(6);
+	BOOST_CHECK_EQUAL((segmentedContainer.begin()+5).value<double>("x"), 0.);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( LidarDataContainer_copy_tests )
+{
+	LidarFile file(lidarFileName);
+	LidarDataContainer lidarContainer;
+	file.loadData(lidarContainer);
+
+	//les copies partagent la description des attributs...
+	LidarDataContainer copiedContainer(lidarContainer);
+	BOOST_CHECK_EQUAL(&copiedContainer.getAttributeMap(), &lidarContainer.getAttributeMap());
+	LidarDataContainer assignedContainer;
+	assignedContainer = lidarContainer;
+	BOOST_CHECK_EQUAL(&assignedContainer.getAttributeMap(), &lidarContainer.getAttributeMap());
+
+	//...jusqu'à ce que l'une d'elles la modifie
+	copiedContainer.addAttribute("normal_z", LidarDataType::float32);
+	BOOST_CHECK(&copiedContainer.getAttributeMap() != &lidarContainer.getAttributeMap());
+	BOOST_CHECK(copiedContainer.checkAttributeIsPresent("normal_z"));
+	BOOST_CHECK(!lidarContainer.checkAttributeIsPresent("normal_z"));
+	BOOST_CHECK_EQUAL(*(lidarContainer.endAttribute<double>("x")-1), lastX);
+
+	assignedContainer.swap(copiedContainer);
+	BOOST_CHECK(assignedContainer.checkAttributeIsPresent("normal_z"));
+	BOOST_CHECK_EQUAL(copiedContainer.pointSize(), lidarContainer.pointSize());
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+	const char* data = lidarContainer.rawData();
+	LidarDataContainer movedContainer(std::move(lidarContainer));
+	BOOST_CHECK_EQUAL(static_cast<const void*>(movedContainer.rawData()), static_cast<const void*>(data));
+	BOOST_CHECK(lidarContainer.empty());
+	BOOST_CHECK_EQUAL(lidarContainer.pointSize(), movedContainer.pointSize());
+
+	copiedContainer = std::move(movedContainer);
+	BOOST_CHECK_EQUAL(static_cast<const void*>(copiedContainer.rawData()), static_cast<const void*>(data));
+	BOOST_CHECK(movedContainer.empty());
+	BOOST_CHECK_EQUAL(*(copiedContainer.endAttribute<double>("x")-1), lastX);
+#endif
+}
+
+
+
+BOOST_AUTO_TEST_CASE( LidarDataContainer_index_tests )
+{
+	LidarFile file(lidarFileName);
+	LidarDataContainer lidarContainer;
+	file.loadData(lidarContainer);
+
+	//indices et distances sur 64 bits
+	BOOST_CHECK_EQUAL(sizeof(LidarDataContainer::IndexType), sizeof(std::size_t));
+	BOOST_CHECK_EQUAL(file.getNbPoints(), lidarContainer.size());
+	BOOST_CHECK_EQUAL(lidarContainer.begin() - lidarContainer.end(), -static_cast<std::ptrdiff_t>(lidarContainer.size()));
+	const LidarDataContainer& constLidarContainer = lidarContainer;
+	BOOST_CHECK_EQUAL(constLidarContainer.begin() - constLidarContainer.end(), -static_cast<std::ptrdiff_t>(lidarContainer.size()));
+	BOOST_CHECK_EQUAL(lidarContainer.beginAttribute<double>("x") - lidarContainer.endAttribute<double>("x"), -static_cast<std::ptrdiff_t>(lidarContainer.size()));
+	BOOST_CHECK_EQUAL(constLidarContainer.beginAttribute<double>("x") - constLidarContainer.endAttribute<double>("x"), -static_cast<std::ptrdiff_t>(lidarContainer.size()));
+	BOOST_CHECK_EQUAL(lidarContainer.beginXYZ<double>() - lidarContainer.endXYZ<double>(), -static_cast<std::ptrdiff_t>(lidarContainer.size()));
+	BOOST_CHECK_EQUAL(constLidarContainer.beginXYZ<double>() - constLidarContainer.endXYZ<double>(), -static_cast<std::ptrdiff_t>(lidarContainer.size()));
+	BOOST_CHECK_EQUAL(*((lidarContainer.endAttribute<double>("x") - 1) + (-static_cast<std::ptrdiff_t>(lidarContainer.size()) + 1)), firstX);
+
+	const LidarDataContainer::IndexType last = lidarContainer.size()-1;
+	BOOST_CHECK_EQUAL(*reinterpret_cast<const double*>(lidarContainer.rawData(last) + lidarContainer.getDecalage("x")), lastX);
+	BOOST_CHECK_EQUAL(lidarContainer.erase(last), last);
+	BOOST_CHECK_EQUAL(lidarContainer.size(), last);
+
+#ifdef LIDARFORMAT_COMPACT_INDEX
+	BOOST_CHECK_EQUAL(sizeof(EchoIndexType), 4u);
+#else
+	BOOST_CHECK_EQUAL(sizeof(EchoIndexType), 8u);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE( AttributeHandle_tests )
+{
+	LidarFile file(lidarFileName);
+	boost::shared_ptr<LidarDataContainer> lidarContainer(new LidarDataContainer);
+	file.loadData(*lidarContainer);
+
+	const AttributeHandle<double> hX = lidarContainer->handle<double>("x");
+	const AttributeHandle<double> hZ = lidarContainer->handle<double>("z");
+	BOOST_CHECK_EQUAL(hX.decalage(), lidarContainer->getDecalage("x"));
+	BOOST_CHECK_THROW(lidarContainer->handle<float>("x"), std::logic_error);
+	BOOST_CHECK_THROW(lidarContainer->handle<double>("absent"), std::logic_error);
+
+	LidarDataContainer::iterator it = lidarContainer->begin();
+	BOOST_CHECK_EQUAL(it.value(hX), firstX);
+	const LidarEcho echo = *it;
+	BOOST_CHECK_EQUAL(echo.value(hZ), firstZ);
+	BOOST_CHECK_EQUAL((lidarContainer->end()-1).value(hX), lastX);
+	it.value(hZ) += 1;
+	BOOST_CHECK_EQUAL(*lidarContainer->beginAttribute(hZ), firstZ+1);
+	BOOST_CHECK_EQUAL(std::distance(lidarContainer->beginAttribute(hZ), lidarContainer->endAttribute(hZ)), static_cast<std::ptrdiff_t>(lidarContainer->size()));
+
+	LidarDataAttView<double> viewX(lidarContainer, hX);
+	BOOST_CHECK_EQUAL(*viewX.begin(), firstX);
+	BOOST_CHECK_EQUAL(viewX.end() - viewX.begin(), static_cast<std::ptrdiff_t>(lidarContainer->size()));
+
+	LidarSegmentedDataContainer segmentedContainer(2);
+	segmentedContainer.setAttributes(lidarContainer->getAttributeMap());
+	segmentedContainer.append(*lidarContainer);
+	const AttributeHandle<double> hSegX = segmentedContainer.handle<double>("x");
+	BOOST_CHECK_EQUAL((segmentedContainer.begin()+1).value(hSegX), (lidarContainer->begin()+1).value(hX));
+}
+
+struct LessEchoZ
+{
+	explicit LessEchoZ(const unsigned int decalage): decalage_(decalage) {}
+
+	bool operator()(const LidarEcho& e1, const LidarEcho& e2) const
+	{
+		return e1.value<double>(decalage_) < e2.value<double>(decalage_);
+	}
+
+	unsigned int decalage_;
+};
+
+BOOST_AUTO_TEST_CASE( LidarEcho_smallBuffer_tests )
+{
+	LidarFile file(lidarFileName);
+	LidarDataContainer lidarContainer;
+	file.loadData(lidarContainer);
+	const unsigned int decalageZ = lidarContainer.getDecalage("z");
+
+	//copie d'un écho par la référence renvoyée par l'itérateur
+	LidarEcho echo = *lidarContainer.begin();
+	BOOST_CHECK_EQUAL(echo.isSmall(), lidarContainer.pointSize() <= LidarEcho::smallEchoSize);
+	BOOST_CHECK_EQUAL(echo.value<double>(decalageZ), firstZ);
+	LidarEcho echoCopy(echo);
+	echoCopy.value<double>(decalageZ) += 1;
+	BOOST_CHECK_EQUAL(echo.value<double>(decalageZ), firstZ);
+	BOOST_CHECK(echoCopy.getRawData() != echo.getRawData());
+
+	LidarEchoRef ref = *lidarContainer.begin();
+	BOOST_CHECK_EQUAL(ref.value<double>(decalageZ), firstZ);
+	BOOST_CHECK_EQUAL(lidarContainer.begin()->value<double>(decalageZ), firstZ);
+	ref = echoCopy;
+	BOOST_CHECK_EQUAL(lidarContainer.begin().value<double>(decalageZ), firstZ+1);
+
+	//écho plus gros que le tampon interne
+	LidarDataContainer bigContainer;
+	for(unsigned int i=0; i<10; ++i)
+		bigContainer.addAttribute(std::string(1, 'a'+i), LidarDataType::float64);
+	BOOST_CHECK(!bigContainer.createEcho().isSmall());
+	LidarEcho bigEcho = bigContainer.createEcho();
+	for(unsigned int i=0; i<4; ++i)
+	{
+		bigEcho.value<double>("j") = 3 - i;
+		bigContainer.push_back(bigEcho);
+	}
+	swap(*bigContainer.begin(), *(bigContainer.begin()+3));
+	BOOST_CHECK_EQUAL(bigContainer.begin().value<double>("j"), 0);
+	BOOST_CHECK_EQUAL((bigContainer.begin()+3).value<double>("j"), 3);
+
+	std::sort(lidarContainer.begin(), lidarContainer.end(), LessEchoZ(decalageZ));
+	for(LidarDataContainer::iterator it = lidarContainer.begin()+1; it != lidarContainer.end(); ++it)
+		BOOST_CHECK((it-1).value<double>(decalageZ) <= it.value<double>(decalageZ));
+}
+
+template<EnumLidarDataType T>
+struct TypeSizeFunctor
+{
+	unsigned int operator()()
+	{
+		return sizeof( typename LidarEnumTypeTraits<T>::type );
+	}
+};
+
+BOOST_AUTO_TEST_CASE( apply_dispatch_tests )
+{
+	BOOST_CHECK_EQUAL((apply<TypeSizeFunctor, unsigned int>(LidarDataType::int16)), 2u);
+	unsigned int (*sizeFunction)() = getApplyFunction<TypeSizeFunctor, unsigned int>(LidarDataType::float64);
+	BOOST_CHECK_EQUAL(sizeFunction(), 8u);
+
+	//les formats ascii lisent et écrivent les échos avec des fonctions résolues une fois par attribut
+	const TemporaryDirectory directory;
+	LidarFile file(lidarFileName);
+	LidarDataContainer lidarContainer;
+	file.loadData(lidarContainer);
+
+	const string lidarFileNameAscii(directory.file("testApplyAscii.xml"));
+	LidarFile::save(lidarContainer, lidarFileNameAscii, cs::DataFormatType::ascii);
+
+	LidarFile fileAscii(lidarFileNameAscii);
+	LidarDataContainer asciiContainer;
+	fileAscii.loadData(asciiContainer);
+	BOOST_CHECK_EQUAL(asciiContainer.size(), lidarContainer.size());
+	BOOST_CHECK_EQUAL(asciiContainer.begin().value<double>("z"), firstZ);
+	BOOST_CHECK_EQUAL((asciiContainer.end()-1).value<double>("x"), lastX);
+}
+
+#pragma pack(push, 1)
+struct PointXYZI
+{
+	float64 x, y, z;
+	uint16 intensity;
+
+	static void describe(LidarSchemaDescription<PointXYZI>& d)
+	{
+		d.add("x", &PointXYZI::x);
+		d.add("y", &PointXYZI::y);
+		d.add("z", &PointXYZI::z);
+		d.add("intensity", &PointXYZI::intensity);
+	}
+};
+#pragma pack(pop)
+
+BOOST_AUTO_TEST_CASE( LidarDataContainerT_tests )
+{
+	LidarFile file(lidarFileName);
+	boost::shared_ptr<LidarDataContainer> lidarContainer(new LidarDataContainer);
+	file.loadData(*lidarContainer);
+
+	//le schéma ne correspond pas encore au conteneur
+	BOOST_CHECK_THROW(LidarDataContainerT<PointXYZI> typedContainer(lidarContainer), std::logic_error);
+
+	lidarContainer->addAttribute("intensity", LidarDataType::uint16);
+	LidarDataContainerT<PointXYZI> typedContainer(lidarContainer);
+	BOOST_CHECK_EQUAL(typedContainer.size(), lidarContainer->size());
+	BOOST_CHECK_EQUAL(typedContainer[0].x, firstX);
+	BOOST_CHECK_EQUAL((typedContainer.end()-1)->z, lastZ);
+
+	//même buffer que le conteneur
+	typedContainer[1].intensity = 42;
+	BOOST_CHECK_EQUAL((lidarContainer->begin()+1).value<uint16>("intensity"), 42);
+	BOOST_CHECK_EQUAL(static_cast<void*>(typedContainer.data()), static_cast<void*>(lidarContainer->rawData()));
+
+	boost::shared_ptr<LidarDataContainer> newContainer(new LidarDataContainer);
+	LidarDataContainerT<PointXYZI>::initAttributes(*newContainer);
+	newContainer->resize(3);
+	LidarDataContainerT<PointXYZI> newTypedContainer(newContainer);
+	BOOST_CHECK_EQUAL(newTypedContainer.begin()->intensity, 0);
+	BOOST_CHECK_EQUAL(newContainer->getDecalage("intensity"), 24u);
+}
+
+struct DeletePointsXYZI
+{
+	explicit DeletePointsXYZI(int* nbCalls): m_nbCalls(nbCalls) {}
+	void operator()(char* data) const
+	{
+		++*m_nbCalls;
+		delete[] reinterpret_cast<PointXYZI*>(data);
+	}
+	int* m_nbCalls;
+};
+
+BOOST_AUTO_TEST_CASE( LidarDataContainer_adoptData_tests )
+{
+	//buffer d'un logiciel d'acquisition
+	const std::size_t nbEchos = 10;
+	PointXYZI* points = new PointXYZI[nbEchos];
+	for(std::size_t i = 0; i < nbEchos; ++i)
+	{
+		points[i].x = static_cast<float64>(i);
+		points[i].y = 2.*i;
+		points[i].z = 3.*i;
+		points[i].intensity = static_cast<uint16>(i);
+	}
+
+	LidarDataContainer::AttributeListType attributes;
+	attributes.push_back(std::make_pair(std::string("x"), LidarDataType::float64));
+	attributes.push_back(std::make_pair(std::string("y"), LidarDataType::float64));
+	attributes.push_back(std::make_pair(std::string("z"), LidarDataType::float64));
+	attributes.push_back(std::make_pair(std::string("intensity"), LidarDataType::uint16));
+
+	int nbCalls = 0;
+	LidarDataContainer lidarContainer;
+	lidarContainer.addAttribute("classification", LidarDataType::uint8);
+	lidarContainer.resize(3);
+	lidarContainer.adoptData(reinterpret_cast<char*>(points), nbEchos, DeletePointsXYZI(&nbCalls), attributes);
+	BOOST_CHECK_EQUAL(lidarContainer.size(), nbEchos);
+	BOOST_CHECK_EQUAL(lidarContainer.pointSize(), sizeof(PointXYZI));
+	BOOST_CHECK(!lidarContainer.checkAttributeIsPresent("classification"));
+	BOOST_CHECK(lidarContainer.rawData() == reinterpret_cast<char*>(points));
+	BOOST_CHECK_EQUAL((lidarContainer.begin()+4).value<uint16>("intensity"), 4);
+	BOOST_CHECK_EQUAL(*(lidarContainer.beginAttribute<double>("z")+5), 15.);
+
+	//écriture sur place
+	lidarContainer.begin().value<double>("x") = -1.;
+	BOOST_CHECK_EQUAL(points[0].x, -1.);
+	BOOST_CHECK_EQUAL(nbCalls, 0);
+
+	//le buffer est rendu dès qu'il doit grandir
+	lidarContainer.push_back(lidarContainer.createEcho());
+	BOOST_CHECK_EQUAL(nbCalls, 1);
+	BOOST_REQUIRE_EQUAL(lidarContainer.size(), nbEchos + 1);
+	BOOST_CHECK_EQUAL((lidarContainer.begin()+9).value<double>("y"), 18.);
+
+	//et dans l'autre sens
+	const char* rawData = lidarContainer.rawData();
+	boost::shared_ptr<char> released = lidarContainer.releaseData();
+	BOOST_CHECK(released.get() == rawData);
+	BOOST_CHECK(lidarContainer.empty());
+	BOOST_CHECK(lidarContainer.checkAttributeIsPresent("intensity"));
+	BOOST_CHECK_EQUAL(reinterpret_cast<PointXYZI*>(released.get())[9].y, 18.);
+	released.reset();
+
+	points = new PointXYZI[2];
+	lidarContainer.adoptData(reinterpret_cast<char*>(points), 2, DeletePointsXYZI(&nbCalls));
+	released = lidarContainer.releaseData();
+	BOOST_CHECK(released.get() == reinterpret_cast<char*>(points));
+	BOOST_CHECK_EQUAL(nbCalls, 1);
+	released.reset();
+	BOOST_CHECK_EQUAL(nbCalls, 2);
+}
+
+BOOST_AUTO_TEST_CASE( LidarDataContainer_sort_tests )
+{
+	LidarFile file(lidarFileName);
+	LidarDataContainer lidarContainer;
+	file.loadData(lidarContainer);
+
+	std::vector<double> z(lidarContainer.beginAttribute<double>("z"), lidarContainer.endAttribute<double>("z"));
+	std::sort(z.begin(), z.end());
+	lidarContainer.sortByAttribute("z");
+	BOOST_CHECK(std::equal(z.begin(), z.end(), lidarContainer.beginAttribute<double>("z")));
+
+	//assez d'échos pour plusieurs threads, clés négatives et égales
+	LidarDataContainer bigContainer;
+	bigContainer.addAttribute("f", LidarDataType::float32);
+	bigContainer.addAttribute("i", LidarDataType::int16);
+	const std::size_t nbEchos = 300000;
+	bigContainer.resize(nbEchos);
+	LidarIteratorAttribute<float32> itf = bigContainer.beginAttribute<float32>("f");
+	LidarIteratorAttribute<int16> iti = bigContainer.beginAttribute<int16>("i");
+	for(std::size_t n = 0; n < nbEchos; ++n, ++itf, ++iti)
+	{
+		*itf = static_cast<float32>((n*7919) % 1000) - 500.5f;
+		*iti = static_cast<int16>((n*104729) % 2000) - 1000;
+	}
+
+	LidarDataContainer inPlaceContainer(bigContainer);
+
+	std::vector<float32> f(bigContainer.beginAttribute<float32>("f"), bigContainer.endAttribute<float32>("f"));
+	std::stable_sort(f.begin(), f.end());
+	bigContainer.sortByAttribute("f", 4);
+	BOOST_CHECK(std::equal(f.begin(), f.end(), bigContainer.beginAttribute<float32>("f")));
+	//les échos entiers sont déplacés
+	std::vector<int16> iSorted(bigContainer.beginAttribute<int16>("i"), bigContainer.endAttribute<int16>("i"));
+	std::sort(iSorted.begin(), iSorted.end());
+
+	std::vector<int16> i(inPlaceContainer.beginAttribute<int16>("i"), inPlaceContainer.endAttribute<int16>("i"));
+	std::sort(i.begin(), i.end());
+	inPlaceContainer.sortByAttribute("i", 4, true);
+	BOOST_CHECK(std::equal(i.begin(), i.end(), inPlaceContainer.beginAttribute<int16>("i")));
+	BOOST_CHECK(i == iSorted);
+
+	std::vector<EchoIndexType> permutation(2, 0);
+	BOOST_CHECK_THROW(lidarContainer.applyPermutation(permutation), std::logic_error);
+
+	//indice hors limites ou répété : rien n'est déplacé, dans les deux modes
+	const LidarDataContainer copiedContainer(lidarContainer);
+	permutation.resize(lidarContainer.size());
+	for(std::size_t n = 0; n < permutation.size(); ++n)
+		permutation[n] = static_cast<EchoIndexType>(permutation.size() - 1 - n);
+	permutation.back() = static_cast<EchoIndexType>(permutation.size());
+	BOOST_CHECK_THROW(lidarContainer.applyPermutation(permutation), std::logic_error);
+	BOOST_CHECK_THROW(lidarContainer.applyPermutation(permutation, 1, true), std::logic_error);
+	permutation.back() = permutation.front();
+	BOOST_CHECK_THROW(lidarContainer.applyPermutation(permutation, 1, true), std::logic_error);
+	BOOST_CHECK(std::equal(copiedContainer.rawData(), copiedContainer.rawData() + copiedContainer.size()*copiedContainer.pointSize(), lidarContainer.rawData()));
+	BOOST_CHECK_THROW(lidarContainer.sortByAttribute("absent"), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE( LidarSpatialReordering_tests )
+{
+	//grille 16x16 dans le désordre
+	LidarDataContainer lidarContainer;
+	lidarContainer.addAttribute("x", LidarDataType::float64);
+	lidarContainer.addAttribute("y", LidarDataType::float32);
+	lidarContainer.addAttribute("z", LidarDataType::float64);
+	const unsigned int nbEchos = 256;
+	lidarContainer.resize(nbEchos);
+	LidarIteratorEcho it = lidarContainer.begin();
+	for(unsigned int n = 0; n < nbEchos; ++n, ++it)
+	{
+		const unsigned int cell = (n*97) % nbEchos;
+		it.value<double>("x") = 1000.5 + cell % 16;
+		it.value<float>("y") = 20.5f + cell / 16;
+	}
+	const LidarDataContainer initialContainer(lidarContainer);
+
+	LidarSpatialReordering hilbertReordering(1., LidarSpatialReordering::hilbert);
+	hilbertReordering.setOriginalIndexAttribute("originalIndex");
+	hilbertReordering.reorder(lidarContainer);
+	BOOST_REQUIRE_EQUAL(lidarContainer.size(), nbEchos);
+
+	//courbe de Hilbert : deux échos consécutifs sont dans des cellules voisines
+	for(LidarIteratorEcho itEcho = lidarContainer.begin()+1; itEcho != lidarContainer.end(); ++itEcho)
+	{
+		const double dx = std::abs(itEcho.value<double>("x") - (itEcho-1).value<double>("x"));
+		const double dy = std::abs(itEcho.value<float>("y") - (itEcho-1).value<float>("y"));
+		BOOST_CHECK_EQUAL(dx + dy, 1.);
+	}
+
+	//l'index d'origine permet de retrouver les échos
+	const LidarDataContainer::IndexType index = lidarContainer.begin().value<EchoIndexType>("originalIndex");
+	BOOST_CHECK_EQUAL((initialContainer.begin()+index).value<double>("x"), lidarContainer.begin().value<double>("x"));
+
+	LidarSpatialReordering mortonReordering(1., LidarSpatialReordering::morton);
+	mortonReordering.setOriginalIndexAttribute("originalIndex");
+	mortonReordering.setNbThreads(2);
+	mortonReordering.reorder(lidarContainer);
+	BOOST_CHECK_EQUAL(lidarContainer.pointSize(), initialContainer.pointSize() + sizeof(EchoIndexType));
+	BOOST_CHECK_EQUAL(lidarContainer.begin().value<double>("x") + lidarContainer.begin().value<float>("y"), 1020.5 + 0.5);
+	double sum = 0;
+	for(unsigned int n = 0; n < 4; ++n)
+		sum += (lidarContainer.begin()+n).value<double>("x") - 1000.5 + (lidarContainer.begin()+n).value<float>("y") - 20.5;
+	BOOST_CHECK_EQUAL(sum, 4.);
+
+	mortonReordering.setUse3D(true);
+	std::vector<EchoIndexType> permutation;
+	mortonReordering.computePermutation(lidarContainer, permutation);
+	std::sort(permutation.begin(), permutation.end());
+	BOOST_CHECK_EQUAL(permutation.back(), nbEchos-1);
+	BOOST_CHECK(std::adjacent_find(permutation.begin(), permutation.end()) == permutation.end());
+}
+
+struct IsOutsideZ
+{
+	IsOutsideZ(const double zMin, const double zMax): zMin_(zMin), zMax_(zMax) {}
+	bool operator()(const double z) const { return z < zMin_ || z > zMax_; }
+	double zMin_, zMax_;
+};
+
+struct IsClass
+{
+	IsClass(const unsigned int decalage, const uint8 classification): decalage_(decalage), classification_(classification) {}
+	bool operator()(const LidarConstIteratorEcho& it) const { return it.value<uint8>(decalage_) == classification_; }
+	unsigned int decalage_;
+	uint8 classification_;
+};
+
+BOOST_AUTO_TEST_CASE( LidarDataContainer_filter_tests )
+{
+	LidarFile file(lidarFileName);
+	LidarDataContainer lidarContainer;
+	file.loadData(lidarContainer);
+
+	std::vector<double> z(lidarContainer.beginAttribute<double>("z"), lidarContainer.endAttribute<double>("z"));
+	z.erase(std::remove_if(z.begin(), z.end(), IsOutsideZ(1076, 1078)), z.end());
+
+	LidarDataContainer filteredContainer;
+	lidarContainer.copyIf(lidarContainer.handle<double>("z"), IsOutsideZ(0, 0), filteredContainer);
+	BOOST_CHECK_EQUAL(filteredContainer.size(), lidarContainer.size());
+
+	const std::size_t nbErased = lidarContainer.eraseIf(lidarContainer.handle<double>("z"), IsOutsideZ(1076, 1078));
+	BOOST_CHECK_EQUAL(nbErased, filteredContainer.size() - z.size());
+	BOOST_REQUIRE_EQUAL(lidarContainer.size(), z.size());
+	BOOST_CHECK(std::equal(z.begin(), z.end(), lidarContainer.beginAttribute<double>("z")));
+
+	//assez d'échos pour plusieurs threads
+	LidarDataContainer bigContainer;
+	bigContainer.addAttribute("index", LidarDataType::uint32);
+	bigContainer.addAttribute("classification", LidarDataType::uint8);
+	const std::size_t nbEchos = 500000;
+	bigContainer.resize(nbEchos);
+	LidarIteratorEcho it = bigContainer.begin();
+	std::size_t nbNoise = 0;
+	for(std::size_t n = 0; n < nbEchos; ++n, ++it)
+	{
+		it.value<uint32>("index") = static_cast<uint32>(n);
+		it.value<uint8>("classification") = static_cast<uint8>((n*31) % 7 == 0 ? 7 : 2);
+		nbNoise += (n*31) % 7 == 0;
+	}
+
+	LidarDataContainer noiseContainer;
+	bigContainer.copyIf(IsClass(bigContainer.getDecalage("classification"), 7), noiseContainer, 4);
+	BOOST_CHECK_EQUAL(noiseContainer.size(), nbNoise);
+	BOOST_CHECK_EQUAL(noiseContainer.pointSize(), bigContainer.pointSize());
+
+	BOOST_CHECK_EQUAL(bigContainer.eraseIf(IsClass(bigContainer.getDecalage("classification"), 7), 4), nbNoise);
+	BOOST_REQUIRE_EQUAL(bigContainer.size(), nbEchos - nbNoise);
+
+	//ordre conservé
+	bool ordered = true;
+	for(LidarDataContainer::iterator itEcho = bigContainer.begin()+1; itEcho != bigContainer.end(); ++itEcho)
+		ordered = ordered && (itEcho-1).value<uint32>("index") < itEcho.value<uint32>("index") && itEcho.value<uint8>("classification") == 2;
+	BOOST_CHECK(ordered);
+}
+
+
+
+struct ShiftSliceZ
+{
+	ShiftSliceZ(std::vector<LidarDataSlice>* slices): m_slices(slices) {}
+	void operator()(const std::size_t first, const std::size_t last) const
+	{
+		for(std::size_t i = first; i < last; ++i)
+		{
+			LidarDataSlice& slice = (*m_slices)[i];
+			for(LidarIteratorAttribute<double> itZ = slice.beginAttribute<double>("z"); itZ != slice.endAttribute<double>("z"); ++itZ)
+				*itZ += static_cast<double>(i);
+		}
+	}
+	std::vector<LidarDataSlice>* m_slices;
+};
+
+BOOST_AUTO_TEST_CASE( LidarDataSlice_tests )
+{
+	LidarFile file(lidarFileName);
+	boost::shared_ptr<LidarDataContainer> lidarContainer(new LidarDataContainer);
+	file.loadData(*lidarContainer);
+	const std::vector<double> z(lidarContainer->beginAttribute<double>("z"), lidarContainer->endAttribute<double>("z"));
+
+	BOOST_CHECK_THROW(LidarDataSlice(lidarContainer, 1, lidarContainer->size()), std::logic_error);
+
+	const std::size_t nbSlices = 4;
+	std::vector<LidarDataSlice> slices = LidarDataSlice::split(lidarContainer, nbSlices);
+	BOOST_REQUIRE_EQUAL(slices.size(), nbSlices);
+	std::size_t total = 0;
+	for(std::size_t i = 0; i < nbSlices; ++i)
+	{
+		BOOST_CHECK_EQUAL(slices[i].first(), total);
+		BOOST_CHECK(slices[i].rawData() == lidarContainer->rawData(total));
+		BOOST_CHECK_EQUAL(slices[i].end() - slices[i].begin(), static_cast<std::ptrdiff_t>(slices[i].size()));
+		total += slices[i].size();
+	}
+	BOOST_CHECK_EQUAL(total, lidarContainer->size());
+
+	//pas de copie : les écritures par les tranches se voient dans le conteneur
+	parallelFor(0, nbSlices, ShiftSliceZ(&slices), nbSlices, 1);
+	bool shifted = true;
+	LidarConstIteratorAttribute<double> itZ = static_cast<const LidarDataContainer&>(*lidarContainer).beginAttribute<double>("z");
+	for(std::size_t i = 0; i < nbSlices; ++i)
+		for(std::size_t n = 0; n < slices[i].size(); ++n, ++itZ)
+			shifted = shifted && *itZ == z[slices[i].first() + n] + i;
+	BOOST_CHECK(shifted);
+
+	//sous-tranche, itérateurs XYZ et vue
+	const LidarDataSlice& lastSlice = slices.back();
+	boost::shared_ptr<LidarDataSlice> subSlice(new LidarDataSlice(lastSlice.slice(1, lastSlice.size() - 1)));
+	BOOST_CHECK_EQUAL(subSlice->first(), lastSlice.first() + 1);
+	BOOST_CHECK_EQUAL(subSlice->beginXYZ<double>().z(), lastSlice.beginAttribute<double>("z")[1]);
+	BOOST_CHECK_EQUAL(subSlice->begin().value<double>("x"), (lidarContainer->begin() + subSlice->first()).value<double>("x"));
+
+	LidarDataAttView<double, LidarDataSlice> viewZ(subSlice, subSlice->handle<double>("z"));
+	BOOST_CHECK_EQUAL(std::distance(viewZ.begin(), viewZ.end()), static_cast<std::ptrdiff_t>(subSlice->size()));
+	BOOST_CHECK(std::equal(viewZ.begin(), viewZ.end(), subSlice->beginAttribute<double>("z")));
+}
+
+
+
+BOOST_AUTO_TEST_CASE( LidarDataTupleView_tests )
+{
+	boost::shared_ptr<LidarDataContainer> lidarContainer(new LidarDataContainer);
+	lidarContainer->addAttribute("x", LidarDataType::float64);
+	lidarContainer->addAttribute("y", LidarDataType::float64);
+	lidarContainer->addAttribute("z", LidarDataType::float64);
+	lidarContainer->addAttribute("intensity", LidarDataType::float32);
+	lidarContainer->addAttribute("classification", LidarDataType::uint8);
+	lidarContainer->resize(100);
+
+	std::vector<std::string> names;
+	names.push_back("x");
+	names.push_back("y");
+	names.push_back("intensity");
+	names.push_back("classification");
+
+	typedef boost::tuple<float64, float64, float32, uint8> PointType;
+	typedef LidarDataTupleView<PointType> ViewType;
+	ViewType view(lidarContainer, names);
+	BOOST_CHECK_EQUAL(std::distance(view.begin(), view.end()), 100);
+
+	int i = 0;
+	for(ViewType::iterator it = view.begin(); it != view.end(); ++it, ++i)
+	{
+		(*it).get<0>() = i;
+		(*it).set<1>(2.*i);
+		(*it).get<2>() = 0.5f*i;
+		(*it).get<3>() = static_cast<uint8>(i%3);
+	}
+	LidarConstIteratorEcho itEcho = static_cast<const LidarDataContainer&>(*lidarContainer).begin() + 51;
+	BOOST_CHECK_EQUAL(itEcho.value<double>("y"), 102.);
+	BOOST_CHECK_EQUAL(itEcho.value<float32>("intensity"), 25.5f);
+	BOOST_CHECK_EQUAL(itEcho.value<uint8>("classification"), 0);
+	BOOST_CHECK_EQUAL(itEcho.value<double>("z"), 0.);
+	BOOST_CHECK_EQUAL((*(view.begin()+10)).get<3>(), 1);
+
+	//mauvais type ou mauvais nombre d'attributs
+	names[2] = "z";
+	BOOST_CHECK_THROW(ViewType(lidarContainer, names), std::logic_error);
+	names.pop_back();
+	BOOST_CHECK_THROW(ViewType(lidarContainer, names), std::logic_error);
+
+	//vue de 3 attributs de même type
+	LidarDataAttProxyView<double, 3> xyzView(lidarContainer, lidarContainer->pointSize(), lidarContainer->getDecalage("x"), lidarContainer->getDecalage("y"), lidarContainer->getDecalage("z"));
+	BOOST_CHECK_EQUAL((*(xyzView.begin()+7)).get<1>(), 14.);
+
+#if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) && !defined(BOOST_NO_CXX11_TEMPLATE_ALIASES)
+	std::vector<std::string> xz;
+	xz.push_back("x");
+	xz.push_back("z");
+	LidarDataMultiAttView<double, double> xzView(lidarContainer, xz);
+	BOOST_CHECK_EQUAL((*(xzView.begin()+3)).get<0>(), 3.);
+#endif
+}
+
+
+BOOST_AUTO_TEST_CASE( LidarDataView_block_tests )
+{
+	LidarFile file(lidarFileName);
+	boost::shared_ptr<LidarDataContainer> lidarContainer(new LidarDataContainer);
+	file.loadData(*lidarContainer);
+	lidarContainer->addAttribute("intensity", LidarDataType::float32);
+	const LidarDataContainer fileContainer(*lidarContainer);
+	for(int k = 0; k < 3; ++k)
+		lidarContainer->append(fileContainer);
+	BOOST_REQUIRE_GT(lidarContainer->size(), 20u);
+
+	//blocs qui ne sont pas des multiples de la taille des registres
+	const std::size_t first = 3, n = lidarContainer->size() - 5;
+	std::vector<double> xs(n), ys(n), zs(n);
+
+	LidarDataAttView<double> viewX(lidarContainer, lidarContainer->handle<double>("x"));
+	viewX.load_block(first, n, &xs[0]);
+	BOOST_CHECK(std::equal(xs.begin(), xs.end(), viewX.begin() + first));
+
+	LidarDataAttProxyView<double, 3> viewXYZ(lidarContainer, lidarContainer->pointSize(), lidarContainer->getDecalage("x"), lidarContainer->getDecalage("y"), lidarContainer->getDecalage("z"));
+	viewXYZ.load_block(first, n, 0, &ys[0], &zs[0]);
+	BOOST_CHECK(std::equal(zs.begin(), zs.end(), lidarContainer->beginAttribute<double>("z") + first));
+	BOOST_CHECK_EQUAL(zs.back(), *(lidarContainer->endAttribute<double>("z") - 3));
+
+	for(std::size_t i = 0; i < n; ++i)
+		xs[i] += ys[i];
+	viewXYZ.store_block(first, n, &xs[0]);
+	BOOST_CHECK_EQUAL((lidarContainer->begin() + first + 5).value<double>("x"), xs[5]);
+	BOOST_CHECK_EQUAL((lidarContainer->begin() + first + 5).value<double>("y"), ys[5]);
+
+	std::vector<std::string> names;
+	names.push_back("z");
+	names.push_back("intensity");
+	LidarDataTupleView<boost::tuple<double, float32> > viewZI(lidarContainer, names);
+	std::vector<float32> intensities(n);
+	for(std::size_t i = 0; i < n; ++i)
+		intensities[i] = 0.25f*i;
+	viewZI.store_block<1>(first, n, &intensities[0]);
+	std::vector<float32> loaded(n + first);
+	viewZI.load_block<1>(0, n + first, &loaded[0]);
+	BOOST_CHECK_EQUAL(loaded[first - 1], 0.f);
+	BOOST_CHECK(std::equal(intensities.begin(), intensities.end(), loaded.begin() + first));
+}
+
+
+BOOST_AUTO_TEST_CASE( LidarSelection_tests )
+{
+	//plusieurs mots de 64 bits, le dernier incomplet
+	const std::size_t size = 150;
+	LidarSelection even(size), multiplesOf3(size);
+	for(std::size_t i = 0; i < size; i += 2)
+		even.set(i);
+	for(std::size_t i = 0; i < size; i += 3)
+		multiplesOf3.set(i);
+	BOOST_CHECK_EQUAL(even.count(), 75u);
+	BOOST_CHECK_EQUAL(multiplesOf3.count(), 50u);
+	BOOST_CHECK_EQUAL((even & multiplesOf3).count(), 25u);
+	BOOST_CHECK_EQUAL((even | multiplesOf3).count(), 100u);
+	BOOST_CHECK_EQUAL((~even).count(), 75u);
+	BOOST_CHECK_EQUAL(LidarSelection(even).subtract(multiplesOf3).count(), 50u);
+	BOOST_CHECK_EQUAL(LidarSelection(size, true).count(), size);
+	BOOST_CHECK(!(~LidarSelection(size, true)).test(size - 1));
+	BOOST_CHECK_THROW(even &= LidarSelection(size + 1), std::logic_error);
+
+	std::vector<EchoIndexType> indices;
+	(even & multiplesOf3).getIndices(indices);
+	BOOST_REQUIRE_EQUAL(indices.size(), 25u);
+	BOOST_CHECK_EQUAL(indices[1], 6u);
+	BOOST_CHECK_EQUAL(indices.back(), 144u);
+	BOOST_CHECK_EQUAL(std::distance(LidarSelection(size).begin(), LidarSelection(size).end()), 0);
+
+	indices.push_back(149);
+	const LidarSelection fromIndices(indices, size);
+	BOOST_CHECK_EQUAL(fromIndices.count(), 26u);
+	BOOST_CHECK(fromIndices.test(149) && fromIndices.test(0) && !fromIndices.test(2));
+	BOOST_CHECK_THROW(LidarSelection(indices, 149), std::logic_error);
+
+	//vue sur la sélection, mêmes valeurs que la vue sur les indices
+	LidarFile file(lidarFileName);
+	boost::shared_ptr<LidarDataContainer> lidarContainer(new LidarDataContainer);
+	file.loadData(*lidarContainer);
+	boost::shared_ptr<LidarSelection> selection(new LidarSelection(lidarContainer->size()));
+	selection->set(1);
+	selection->set(4);
+	selection->set(lidarContainer->size() - 1);
+	boost::shared_ptr<std::vector<EchoIndexType> > index(new std::vector<EchoIndexType>);
+	selection->getIndices(*index);
+
+	const unsigned int stride = lidarContainer->pointSize();
+	typedef LidarDataAttProxySelectionView<double, 2> SelectionViewType;
+	typedef LidarDataAttProxyIndexView<double, 2> IndexViewType;
+	SelectionViewType selectionView(lidarContainer, selection, stride, lidarContainer->getDecalage("x"), lidarContainer->getDecalage("z"));
+	IndexViewType indexView(lidarContainer, index, stride, lidarContainer->getDecalage("x"), lidarContainer->getDecalage("z"));
+	BOOST_CHECK_EQUAL(std::distance(selectionView.begin(), selectionView.end()), 3);
+	IndexViewType::iterator itIndex = indexView.begin();
+	bool same = true;
+	for(SelectionViewType::iterator it = selectionView.begin(); it != selectionView.end(); ++it, ++itIndex)
+		same = same && (*it).get<0>() == (*itIndex).get<0>() && (*it).get<1>() == (*itIndex).get<1>();
+	BOOST_CHECK(same);
+	BOOST_CHECK_EQUAL((*selectionView.begin()).get<1>(), *(lidarContainer->beginAttribute<double>("z") + 1));
+}
+
+
+BOOST_AUTO_TEST_CASE( LidarDataAttProxyIndexView_prefetch_tests )
+{
+	LidarFile file(lidarFileName);
+	boost::shared_ptr<LidarDataContainer> lidarContainer(new LidarDataContainer);
+	file.loadData(*lidarContainer);
+
+	boost::shared_ptr<std::vector<EchoIndexType> > index(new std::vector<EchoIndexType>);
+	for(EchoIndexType i = lidarContainer->size(); i > 0; i -= 2)
+		index->push_back(i - 1);
+
+	typedef LidarDataAttProxyIndexView<double, 2> ViewType;
+	ViewType view(lidarContainer, index, lidarContainer->pointSize(), lidarContainer->getDecalage("x"), lidarContainer->getDecalage("z"));
+
+	//distance plus grande ou plus petite que le nombre d'indices
+	const unsigned int distances[2] = {ViewType::defaultPrefetchDistance, 2};
+	for(int d = 0; d < 2; ++d)
+	{
+		ViewType::iterator it = view.begin();
+		bool same = true;
+		std::ptrdiff_t n = 0;
+		for(ViewType::prefetch_iterator itPrefetch = view.prefetch_begin(distances[d]); itPrefetch != view.prefetch_end(); ++itPrefetch, ++it, ++n)
+			same = same && (*itPrefetch).get<0>() == (*it).get<0>() && (*itPrefetch).get<1>() == (*it).get<1>();
+		BOOST_CHECK(same);
+		BOOST_CHECK_EQUAL(n, static_cast<std::ptrdiff_t>(index->size()));
+	}
+
+	view.sort_indices();
+	BOOST_CHECK_EQUAL(index->front(), lidarContainer->size() - 1);
+	BOOST_CHECK_EQUAL((*view.prefetch_begin()).get<1>(), *(lidarContainer->beginAttribute<double>("z") + 1));
+	BOOST_CHECK_EQUAL((*(--view.end())).get<0>(), lastX);
+}
+
+
+struct CountChunk : public detail::_ThreadPoolTask
+{
+	explicit CountChunk(std::vector<int>* counts): m_counts(counts) {}
+	void operator()(const std::size_t chunk) const
+	{
+		//chunks de coût inégal
+		volatile double sum = 0.;
+		for(std::size_t i = 0; i < (chunk%7)*1000; ++i)
+			sum += i;
+		++(*m_counts)[chunk];
+	}
+	std::vector<int>* m_counts;
+};
+
+struct IncrementClassification
+{
+	explicit IncrementClassification(unsigned int decalage): m_decalage(decalage) {}
+	void operator()(const LidarEchoRef& echo) const
+	{
+		++*reinterpret_cast<uint8*>(echo.getRawData() + m_decalage);
+	}
+	unsigned int m_decalage;
+};
+
+struct AddOne
+{
+	explicit AddOne(std::vector<int>* counts): m_counts(counts) {}
+	void operator()(std::size_t first, std::size_t last) const
+	{
+		for( ; first < last; ++first)
+			++(*m_counts)[first];
+	}
+	std::vector<int>* m_counts;
+};
+
+struct NestedParallelFor
+{
+	void operator()(std::vector<int>& counts) const
+	{
+		parallelFor(0, counts.size(), AddOne(&counts), 4, 1);
+	}
+};
+
+struct Half
+{
+	double operator()(const double x) const { return 0.5*x; }
+};
+
+struct SumXZ
+{
+	double operator()(const ViewProxyElement<double, 2>& xz) const { return xz.get<0>() + xz.get<1>(); }
+};
+
+struct GreaterThan
+{
+	explicit GreaterThan(double threshold): m_threshold(threshold) {}
+	bool operator()(const double value) const { return value > m_threshold; }
+	double m_threshold;
+};
+
+BOOST_AUTO_TEST_CASE( ParallelAlgorithms_tests )
+{
+	ThreadPool pool;
+	std::vector<int> counts(1000, 0);
+	pool.run(counts.size(), CountChunk(&counts), 4);
+	BOOST_CHECK_EQUAL(std::count(counts.begin(), counts.end(), 1), 1000);
+	BOOST_CHECK_EQUAL(pool.nbWorkers(), 3u);
+	pool.run(counts.size(), CountChunk(&counts), 2);
+	BOOST_CHECK_EQUAL(std::count(counts.begin(), counts.end(), 2), 1000);
+
+	boost::shared_ptr<LidarDataContainer> lidarContainer(new LidarDataContainer);
+	lidarContainer->addAttribute("x", LidarDataType::float64);
+	lidarContainer->addAttribute("z", LidarDataType::float64);
+	lidarContainer->addAttribute("classification", LidarDataType::uint8);
+	const std::size_t nbEchos = 100000;
+	lidarContainer->resize(nbEchos);
+	LidarIteratorAttribute<double> itX = lidarContainer->beginAttribute<double>("x");
+	for(std::size_t i = 0; i < nbEchos; ++i, ++itX)
+		*itX = static_cast<double>(i);
+
+	//conteneur
+	parallel_for_each(*lidarContainer, IncrementClassification(lidarContainer->getDecalage("classification")), 4, 1000);
+	parallel_for_each(*lidarContainer, IncrementClassification(lidarContainer->getDecalage("classification")), 4, 1000);
+	BOOST_CHECK_EQUAL((std::size_t)std::count(lidarContainer->beginAttribute<uint8>("classification"), lidarContainer->endAttribute<uint8>("classification"), 2), nbEchos);
+
+	//vues
+	LidarDataAttView<double> viewX(lidarContainer, lidarContainer->handle<double>("x"));
+	LidarDataAttView<double> viewZ(lidarContainer, lidarContainer->handle<double>("z"));
+	parallel_transform(viewX, viewZ.begin(), Half(), 4, 1000);
+	BOOST_CHECK_EQUAL(*(lidarContainer->beginAttribute<double>("z") + 501), 250.5);
+	const double sumX = parallel_reduce(viewX, 0., std::plus<double>(), 4, 1000);
+	BOOST_CHECK_EQUAL(sumX, nbEchos*(nbEchos - 1)/2.);
+
+	//résultats partiels bool : un par chunk, écrits en même temps par les threads
+	BOOST_CHECK(parallel_transform_reduce(viewX, false, std::logical_or<bool>(), GreaterThan(nbEchos - 2.), 4, 1));
+	BOOST_CHECK(parallel_transform_reduce(viewX, true, std::logical_and<bool>(), GreaterThan(-1.), 4, 1));
+	BOOST_CHECK(!parallel_transform_reduce(viewX, true, std::logical_and<bool>(), GreaterThan(0.), 4, 1));
+
+	LidarDataAttProxyView<double, 2> viewXZ(lidarContainer, lidarContainer->pointSize(), lidarContainer->getDecalage("x"), lidarContainer->getDecalage("z"));
+	BOOST_CHECK_EQUAL(parallel_transform_reduce(viewXZ, 0., std::plus<double>(), SumXZ(), 0, 1000), 1.5*sumX);
+
+	boost::shared_ptr<std::vector<EchoIndexType> > index(new std::vector<EchoIndexType>);
+	for(EchoIndexType i = 0; i < nbEchos; i += 10)
+		index->push_back(i);
+	LidarDataAttProxyIndexView<double, 2> indexView(lidarContainer, index, lidarContainer->pointSize(), lidarContainer->getDecalage("x"), lidarContainer->getDecalage("z"));
+	BOOST_CHECK_EQUAL(parallel_transform_reduce(indexView, 0., std::plus<double>(), SumXZ(), 3, 100), 1.5*(nbEchos/10)*(nbEchos - 10)/2.);
+
+	//boucle parallèle dans une boucle parallèle : exécutée par le thread appelant
+	std::vector<std::vector<int> > nestedCounts(8, std::vector<int>(10, 0));
+	parallel_for_each(nestedCounts, NestedParallelFor(), 4, 1);
+	bool allOnes = true;
+	for(std::size_t i = 0; i < nestedCounts.size(); ++i)
+		allOnes = allOnes && std::count(nestedCounts[i].begin(), nestedCounts[i].end(), 1) == 10;
+	BOOST_CHECK(allOnes);
+}
+
+
+struct Centered
+{
+	explicit Centered(double center): m_center(center) {}
+	double operator()(const double value) const { return value - m_center; }
+	double m_center;
+};
+
+//z au-dessus d'un plan z = a*x
+struct HeightAbovePlane
+{
+	explicit HeightAbovePlane(double a): m_a(a) {}
+	double operator()(const ViewProxyElement<double, 2>& xz) const { return xz.get<1>() - m_a*xz.get<0>(); }
+	double m_a;
+};
+
+BOOST_AUTO_TEST_CASE( LidarDataComputedView_tests )
+{
+	boost::shared_ptr<LidarDataContainer> lidarContainer(new LidarDataContainer);
+	lidarContainer->addAttribute("x", LidarDataType::float64);
+	lidarContainer->addAttribute("z", LidarDataType::float64);
+	const std::size_t nbEchos = 1000;
+	lidarContainer->resize(nbEchos);
+	LidarIteratorEcho it = lidarContainer->begin();
+	for(std::size_t i = 0; i < nbEchos; ++i, ++it)
+	{
+		it.value<double>("x") = static_cast<double>(i);
+		it.value<double>("z") = 2.*i + 10.;
+	}
+
+	typedef LidarDataAttView<double> ViewType;
+	ViewType viewX(lidarContainer, lidarContainer->handle<double>("x"));
+	LidarDataComputedView<double, ViewType, Centered> centeredX(viewX, Centered(500.));
+	BOOST_CHECK_EQUAL(centeredX.end() - centeredX.begin(), static_cast<std::ptrdiff_t>(nbEchos));
+	BOOST_CHECK_EQUAL(*centeredX.begin(), -500.);
+	BOOST_CHECK_EQUAL(centeredX.begin()[700], 200.);
+
+	//vue calculée sur une vue calculée
+	LidarDataComputedView<double, LidarDataComputedView<double, ViewType, Centered>, Centered> twiceCenteredX = makeComputedView<double>(centeredX, Centered(-1.));
+	BOOST_CHECK_EQUAL(*(twiceCenteredX.end() - 1), 500.);
+
+	LidarDataAttProxyView<double, 2> viewXZ(lidarContainer, lidarContainer->pointSize(), lidarContainer->getDecalage("x"), lidarContainer->getDecalage("z"));
+	typedef LidarDataComputedView<double, LidarDataAttProxyView<double, 2>, HeightAbovePlane> HeightViewType;
+	HeightViewType height(viewXZ, HeightAbovePlane(2.));
+	BOOST_CHECK_EQUAL(std::count(height.begin(), height.end(), 10.), static_cast<std::ptrdiff_t>(nbEchos));
+	BOOST_CHECK_EQUAL(parallel_reduce(height, 0., std::plus<double>(), 4, 100), 10.*nbEchos);
+
+	std::vector<double> block(10);
+	height.load_block(990, 10, &block[0]);
+	BOOST_CHECK_EQUAL(std::count(block.begin(), block.end(), 10.), 10);
+	centeredX.load_block(0, 10, &block[0]);
+	BOOST_CHECK_EQUAL(block[9], -491.);
+}
+
+BOOST_AUTO_TEST_CASE( LidarDataConvertView_tests )
+{
+	boost::shared_ptr<LidarDataContainer> lidarContainer(new LidarDataContainer);
+	lidarContainer->addAttribute("x", LidarDataType::float64);
+	lidarContainer->addAttribute("intensity", LidarDataType::uint16);
+	const std::size_t nbEchos = 1000; //plusieurs blocs, et une fin de bloc partielle
+	lidarContainer->resize(nbEchos);
+	LidarIteratorEcho it = lidarContainer->begin();
+	for(std::size_t i = 0; i < nbEchos; ++i, ++it)
+	{
+		it.value<double>("x") = 650000. + 0.5*i;
+		it.value<uint16>("intensity") = static_cast<uint16>(4*i);
+	}
+
+	//double -> float, recentré
+	LidarDataConvertView<float32, float64> viewX(lidarContainer, lidarContainer->handle<double>("x"), 1., -650000.);
+	BOOST_CHECK_EQUAL(viewX.end() - viewX.begin(), static_cast<std::ptrdiff_t>(nbEchos));
+	BOOST_CHECK_EQUAL(*(viewX.begin() + 999), 499.5f);
+
+	std::vector<float32> block(nbEchos - 3);
+	viewX.load_block(3, nbEchos - 3, &block[0]);
+	BOOST_CHECK(std::equal(block.begin(), block.end(), viewX.begin() + 3));
+	BOOST_CHECK_EQUAL(block[0], 1.5f);
+
+	//uint16 -> float, avec un facteur d'échelle
+	LidarDataConvertView<float32, uint16> viewIntensity(lidarContainer, lidarContainer->getDecalage("intensity"), lidarContainer->pointSize(), 0.25);
+	BOOST_CHECK_EQUAL(*(viewIntensity.begin() + 10), 10.f);
+	viewIntensity.load_block(0, nbEchos - 3, &block[0]);
+	BOOST_CHECK(std::equal(block.begin(), block.end(), viewIntensity.begin()));
+	BOOST_CHECK_EQUAL(block[996], 996.f);
+}
+
+
+struct InBox
+{
+	InBox(double xmin, double xmax): m_xmin(xmin), m_xmax(xmax) {}
+	bool operator()(const LidarConstIteratorEcho& it) const
+	{
+		const double x = it.value<double>("x");
+		return x >= m_xmin && x < m_xmax;
+	}
+	double m_xmin, m_xmax;
+};
+
+struct EqualTo
+{
+	explicit EqualTo(uint8 value): m_value(value) {}
+	bool operator()(const uint8 value) const { return value == m_value; }
+	uint8 m_value;
+};
+
+//hauteur au-dessus du plan z = 0.5*x, dans l'attribut height
+struct ComputeHeight
+{
+	ComputeHeight(const AttributeHandle<double>& x, const AttributeHandle<double>& z, const AttributeHandle<float32>& height): m_x(x), m_z(z), m_height(height) {}
+	void operator()(const LidarIteratorEcho& it) const
+	{
+		it.value(m_height) = static_cast<float32>(it.value(m_z) - 0.5*it.value(m_x));
+	}
+	AttributeHandle<double> m_x, m_z;
+	AttributeHandle<float32> m_height;
+};
+
+BOOST_AUTO_TEST_CASE( LidarPipeline_tests )
+{
+	LidarDataContainer lidarContainer;
+	lidarContainer.addAttribute("x", LidarDataType::float64);
+	lidarContainer.addAttribute("z", LidarDataType::float64);
+	lidarContainer.addAttribute("classification", LidarDataType::uint8);
+	lidarContainer.addAttribute("height", LidarDataType::float32);
+	const std::size_t nbEchos = 1000;
+	lidarContainer.resize(nbEchos);
+	LidarIteratorEcho it = lidarContainer.begin();
+	for(std::size_t i = 0; i < nbEchos; ++i, ++it)
+	{
+		it.value<double>("x") = 1000. + i;
+		it.value<double>("z") = static_cast<double>(i);
+		it.value<uint8>("classification") = static_cast<uint8>(i%4);
+	}
+	const LidarDataContainer copy(lidarContainer);
+
+	const AttributeHandle<double> hX = lidarContainer.handle<double>("x");
+	const AttributeHandle<double> hZ = lidarContainer.handle<double>("z");
+	const AttributeHandle<uint8> hClass = lidarContainer.handle<uint8>("classification");
+
+	//centrage, classe 2, boîte, hauteur : une seule passe, sans conteneur intermédiaire
+	LidarDataContainer result;
+	const std::size_t nbResult = makePipeline(lidarContainer)
+			.transform(hX, Centered(1000.))
+			.filter(hClass, EqualTo(2))
+			.filter(InBox(100., 200.))
+			.transform(ComputeHeight(hX, hZ, lidarContainer.handle<float32>("height")))
+			.copyTo(result);
+	BOOST_CHECK_EQUAL(nbResult, 25u);
+	BOOST_REQUIRE_EQUAL(result.size(), 25u);
+	BOOST_CHECK_EQUAL(result.begin().value<double>("x"), 102.);
+	BOOST_CHECK_EQUAL(result.begin().value<float32>("height"), 51.f);
+	BOOST_CHECK_EQUAL((result.end()-1).value<double>("z"), 198.);
+
+	//la source n'est pas modifiée
+	BOOST_CHECK(std::equal(copy.beginAttribute<double>("x"), copy.endAttribute<double>("x"), static_cast<const LidarDataContainer&>(lidarContainer).beginAttribute<double>("x")));
+	BOOST_CHECK_EQUAL(*static_cast<const LidarDataContainer&>(lidarContainer).beginAttribute<float32>("height"), 0.f);
+
+	BOOST_CHECK_EQUAL(makePipeline(lidarContainer).filter(hClass, EqualTo(1)).count(), 250u);
+	BOOST_CHECK_EQUAL(makePipeline(lidarContainer).filter(InBox(1000., 1010.)).reduce(hZ, 0., std::plus<double>()), 45.);
+
+	//projection sur une partie des attributs, sur une tranche
+	boost::shared_ptr<LidarDataContainer> shared(new LidarDataContainer(lidarContainer));
+	LidarDataContainer projected;
+	projected.addAttribute("z", LidarDataType::float64);
+	projected.addAttribute("classification", LidarDataType::uint8);
+	BOOST_CHECK_EQUAL(makePipeline(LidarDataSlice(shared, 10, 20)).filter(hClass, EqualTo(3)).copyTo(projected), 5u);
+	BOOST_CHECK_EQUAL(projected.pointSize(), 9u);
+	BOOST_CHECK_EQUAL(projected.begin().value<double>("z"), 11.);
+	BOOST_CHECK_EQUAL(projected.begin().value<uint8>("classification"), 3);
+
+	LidarDataContainer wrongType;
+	wrongType.addAttribute("z", LidarDataType::float32);
+	BOOST_CHECK_THROW(makePipeline(lidarContainer).copyTo(wrongType), std::logic_error);
+
+	//échos d'une vue indexée ou d'une sélection, dans l'ordre des indices
+	std::vector<EchoIndexType> indices;
+	indices.push_back(5);
+	indices.push_back(1);
+	indices.push_back(999);
+	indices.push_back(3);
+	BOOST_CHECK_EQUAL(makePipeline(lidarContainer, indices).count(), 4u);
+	BOOST_CHECK_EQUAL(makePipeline(lidarContainer, indices).filter(hClass, EqualTo(3)).reduce(hZ, 0., std::plus<double>()), 1002.);
+	BOOST_CHECK_EQUAL(makePipeline(lidarContainer, indices).transform(hX, Centered(1000.)).reduce(hX, 0., std::plus<double>()), 1008.);
+	LidarDataContainer subset;
+	makePipeline(lidarContainer, indices).copyTo(subset);
+	BOOST_REQUIRE_EQUAL(subset.size(), 4u);
+	BOOST_CHECK_EQUAL((subset.begin()+2).value<double>("z"), 999.);
+
+	const LidarSelection selection(indices, nbEchos);
+	BOOST_CHECK_EQUAL(makePipeline(lidarContainer, selection).filter(InBox(1002., 2000.)).reduce(hZ, 0., std::plus<double>()), 1007.);
+
+	//le conteneur lu reçoit les échos copiés : ajoutés une fois la lecture finie
+	LidarDataContainer grown(copy);
+	BOOST_CHECK_EQUAL(makePipeline(grown).filter(hClass, EqualTo(0)).copyTo(grown), 250u);
+	BOOST_REQUIRE_EQUAL(grown.size(), nbEchos + 250);
+	BOOST_CHECK_EQUAL((grown.end()-1).value<double>("z"), 996.);
+	BOOST_CHECK(std::equal(copy.rawData(), copy.rawData() + nbEchos*copy.pointSize(), grown.rawData()));
+	BOOST_CHECK_EQUAL(makePipeline(LidarDataSlice(shared, 0, 8)).filter(hClass, EqualTo(1)).copyTo(*shared), 2u);
+	BOOST_CHECK_EQUAL((shared->end()-1).value<double>("z"), 5.);
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()